@@ -0,0 +1,254 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "admission.h"
+#include "../edf/edf.h"
+#include "../rta/rta.h"
+
+// Tasks room is made for at first, doubled whenever it runs out
+#define INITIAL_CAPACITY 16
+
+// An admitted task's terms of the utilization and density totals
+typedef struct Admitted {
+
+    unsigned int id;
+    double utilization;
+    double density;
+
+} Admitted;
+
+struct TaskSystem {
+
+    AdmissionPolicy policy;
+
+    // Admitted tasks in priority order, with their ids and, under RM and
+    // DM, their response times. Ids count up in admission order, so they
+    // are set.input
+    PrioritySet set;
+    unsigned int *ids;
+    double *response;
+    unsigned int capacity;
+
+    // Response times of the tasks below a new one, restored if it's rejected
+    double *saved;
+
+    // Every admitted task in admission order, so a removal can add up the
+    // totals again in the order the admissions did, which is the order the
+    // batch analyses add them up in
+    Admitted *admitted;
+
+    unsigned int next_id;
+    double utilization;
+    double density;
+
+};
+
+TaskSystem *ts_create(AdmissionPolicy policy) {
+
+    TaskSystem *system = calloc(1, sizeof(TaskSystem));
+    system->policy = policy;
+    return system;
+}
+
+void ts_free(TaskSystem *system) {
+
+    free(system->set.wcet);
+    free(system->set.period);
+    free(system->set.deadline);
+    free(system->set.inv_period);
+    free(system->ids);
+    free(system->response);
+    free(system->saved);
+    free(system->admitted);
+    free(system);
+}
+
+static void reserve(TaskSystem *system, unsigned int num_tasks) {
+
+    if (num_tasks <= system->capacity) {
+        return;
+    }
+
+    unsigned int capacity = system->capacity ? 2 * system->capacity : INITIAL_CAPACITY;
+    system->set.wcet = realloc(system->set.wcet, capacity * sizeof(double));
+    system->set.period = realloc(system->set.period, capacity * sizeof(double));
+    system->set.deadline = realloc(system->set.deadline, capacity * sizeof(double));
+    system->set.inv_period = realloc(system->set.inv_period, capacity * sizeof(double));
+    system->ids = realloc(system->ids, capacity * sizeof(unsigned int));
+    system->set.input = system->ids;
+    system->response = realloc(system->response, capacity * sizeof(double));
+    system->saved = realloc(system->saved, capacity * sizeof(double));
+    system->admitted = realloc(system->admitted, capacity * sizeof(Admitted));
+    system->capacity = capacity;
+}
+
+// Moves count tasks starting at from to start at to
+static void shift(TaskSystem *system, unsigned int from, unsigned int to, unsigned int count) {
+
+    PrioritySet *set = &system->set;
+
+    memmove(set->wcet + to, set->wcet + from, count * sizeof(double));
+    memmove(set->period + to, set->period + from, count * sizeof(double));
+    memmove(set->deadline + to, set->deadline + from, count * sizeof(double));
+    memmove(set->inv_period + to, set->inv_period + from, count * sizeof(double));
+    memmove(system->ids + to, system->ids + from, count * sizeof(unsigned int));
+    memmove(system->response + to, system->response + from, count * sizeof(double));
+}
+
+static double window(const Task *task) {
+
+    return fmin(task->deadline, task->period);
+
+}
+
+static int find(TaskSystem *system, unsigned int id) {
+
+    for (unsigned int k = 0; k < system->set.num_tasks; k++) {
+        if (system->ids[k] == id) {
+            return (int) k;
+        }
+    }
+
+    return -1;
+}
+
+// Demand analysis of the tasks as they stand, for densities over 1
+static int edf_schedulable(TaskSystem *system) {
+
+    unsigned int n = system->set.num_tasks;
+    Task tasks[n + 1];
+    TaskSet task_set = {n, tasks, NULL};
+
+    for (unsigned int k = 0; k < n; k++) {
+        tasks[k] = (Task) {system->set.wcet[k], system->set.deadline[k], system->set.period[k]};
+    }
+
+    return edf_analysis(&task_set).is_schedulable;
+}
+
+int ts_try_add(TaskSystem *system, Task task, unsigned int *id) {
+
+    double utilization = task.wcet / task.period;
+    if (system->utilization + utilization > 1.0) {
+        return 0;
+    }
+
+    unsigned int n = system->set.num_tasks;
+    reserve(system, n + 1);
+
+    PrioritySet *set = &system->set;
+    const double *keys = system->policy == ADMISSION_RM ? set->period : set->deadline;
+    double key = system->policy == ADMISSION_RM ? task.period : task.deadline;
+
+    // After every task of equal priority, those came first
+    unsigned int p = 0;
+    while (p < n && keys[p] <= key) {
+        p++;
+    }
+
+    unsigned int below = n - p;
+    memcpy(system->saved, system->response + p, below * sizeof(double));
+    shift(system, p, p + 1, below);
+
+    set->wcet[p] = task.wcet;
+    set->period[p] = task.period;
+    set->deadline[p] = task.deadline;
+    set->inv_period[p] = 1.0 / task.period;
+    system->ids[p] = system->next_id;
+    set->num_tasks = n + 1;
+
+    int admitted;
+    double task_density = task.wcet > 0 ? task.wcet / window(&task) : 0.0;
+    double density = system->density + task_density;
+
+    if (system->policy == ADMISSION_EDF) {
+        system->response[p] = NAN;
+        admitted = density <= 1.0 || edf_schedulable(system);
+    } else {
+        // The tasks below only gain interference, so each one's old response
+        // time is a lower bound to start its recurrence from. The new task
+        // has none and starts from 0
+        system->response[p] = 0.0;
+        admitted = rta_schedulable_from(set, p, system->response);
+    }
+
+    if (!admitted) {
+        shift(system, p + 1, p, below);
+        memcpy(system->response + p, system->saved, below * sizeof(double));
+        set->num_tasks = n;
+        return 0;
+    }
+
+    system->admitted[n] = (Admitted) {system->next_id, utilization, task_density};
+    *id = system->next_id++;
+    system->utilization += utilization;
+    system->density = density;
+    return 1;
+}
+
+int ts_remove(TaskSystem *system, unsigned int id) {
+
+    int found = find(system, id);
+    if (found < 0) {
+        return -1;
+    }
+
+    unsigned int p = (unsigned int) found;
+    PrioritySet *set = &system->set;
+
+    shift(system, p + 1, p, set->num_tasks - p - 1);
+    set->num_tasks--;
+
+    // Ids count up in admission order, so the list is sorted by them
+    unsigned int a = 0;
+    while (system->admitted[a].id != id) {
+        a++;
+    }
+    memmove(system->admitted + a, system->admitted + a + 1, (set->num_tasks - a) * sizeof(Admitted));
+
+    // Summed afresh so the running totals don't drift over many changes
+    system->utilization = 0.0;
+    system->density = 0.0;
+    for (unsigned int k = 0; k < set->num_tasks; k++) {
+        system->utilization += system->admitted[k].utilization;
+        system->density += system->admitted[k].density;
+    }
+
+    // Less interference can only shorten the response times below, which
+    // makes the old ones upper bounds and leaves 0 to start from
+    if (system->policy != ADMISSION_EDF) {
+        for (unsigned int k = p; k < set->num_tasks; k++) {
+            system->response[k] = 0.0;
+        }
+        rta_schedulable_from(set, p, system->response);
+    }
+
+    return 0;
+}
+
+int ts_query(TaskSystem *system, unsigned int id, TaskStatus *status) {
+
+    int found = find(system, id);
+    if (found < 0) {
+        return -1;
+    }
+
+    unsigned int k = (unsigned int) found;
+    status->task = (Task) {system->set.wcet[k], system->set.deadline[k], system->set.period[k]};
+    status->priority = k;
+    status->response = system->response[k];
+    return 0;
+}
+
+unsigned int ts_size(TaskSystem *system) {
+
+    return system->set.num_tasks;
+
+}
+
+double ts_utilization(TaskSystem *system) {
+
+    return system->utilization;
+
+}
@@ -0,0 +1,61 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "../task_types.h"
+
+/*
+ * Online admission control: tasks are admitted one at a time only if the
+ * system stays schedulable with them, and can leave again at any time.
+ *
+ * Under RM and DM the tasks are kept in priority order along with their
+ * worst-case response times. A new task leaves the tasks above it alone and
+ * only adds interference below it, so just its own response time and those
+ * of lower priority tasks are recomputed, and a rejected task stops at the
+ * first one that misses, each starting from its old response time. A
+ * response time that lands on a release is confirmed from 0 (see
+ * rta_schedulable_from), and removing a task recomputes the ones below it
+ * from 0, so verdicts and response times are bit for bit the ones rm and
+ * dm give for the admitted tasks in admission order. Ties between equal
+ * periods or deadlines go to the task admitted first.
+ *
+ * Under EDF a task is admitted right away if the density stays at most 1,
+ * and otherwise after a full processor demand analysis of the new set.
+ */
+
+typedef enum AdmissionPolicy {
+
+    ADMISSION_EDF,
+    ADMISSION_RM,
+    ADMISSION_DM,
+
+} AdmissionPolicy;
+
+typedef struct TaskSystem TaskSystem;
+
+typedef struct TaskStatus {
+
+    Task task;
+
+    // Position in priority order, 0 the highest. Under EDF the position by
+    // relative deadline
+    unsigned int priority;
+
+    // Worst-case response time, NAN under EDF
+    double response;
+
+} TaskStatus;
+
+TaskSystem *ts_create(AdmissionPolicy policy);
+void ts_free(TaskSystem *system);
+
+// Returns 1 and sets *id if task was admitted, 0 if it was turned away
+int ts_try_add(TaskSystem *system, Task task, unsigned int *id);
+
+// Returns 0, or -1 if no admitted task has this id
+int ts_remove(TaskSystem *system, unsigned int id);
+int ts_query(TaskSystem *system, unsigned int id, TaskStatus *status);
+
+unsigned int ts_size(TaskSystem *system);
+double ts_utilization(TaskSystem *system);
+
+#endif //ADMISSION_H
@@ -0,0 +1,79 @@
+#include <stdalign.h>
+#include <stdlib.h>
+
+#include "arena.h"
+
+struct ArenaChunk {
+
+    ArenaChunk *next;
+    size_t size;
+    size_t used;
+    alignas(ARENA_ALIGN) unsigned char data[];
+
+};
+
+void arena_init(Arena *arena, size_t chunk_size) {
+
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->chunk_size = chunk_size;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t) (ARENA_ALIGN - 1);
+
+    // Chunks after the current one are left over from before a reset
+    ArenaChunk *chunk = arena->current;
+    while (chunk != NULL && chunk->size - chunk->used < size) {
+        chunk = chunk->next;
+        if (chunk != NULL) {
+            chunk->used = 0;
+        }
+    }
+
+    if (chunk == NULL) {
+
+        size_t chunk_size = size > arena->chunk_size ? size : arena->chunk_size;
+        chunk = malloc(sizeof(ArenaChunk) + chunk_size);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->size = chunk_size;
+        chunk->used = 0;
+
+        // Linked in after the current chunk, ahead of any not reached yet
+        if (arena->current == NULL) {
+            chunk->next = arena->first;
+            arena->first = chunk;
+        } else {
+            chunk->next = arena->current->next;
+            arena->current->next = chunk;
+        }
+    }
+
+    arena->current = chunk;
+
+    void *memory = chunk->data + chunk->used;
+    chunk->used += size;
+    return memory;
+}
+
+void arena_reset(Arena *arena) {
+
+    arena->current = arena->first;
+    if (arena->first != NULL) {
+        arena->first->used = 0;
+    }
+}
+
+void arena_free(Arena *arena) {
+
+    while (arena->first != NULL) {
+        ArenaChunk *next = arena->first->next;
+        free(arena->first);
+        arena->first = next;
+    }
+
+    arena->current = NULL;
+}
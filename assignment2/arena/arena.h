@@ -0,0 +1,42 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/*
+ * Bump allocator over a list of chunks. Allocations are carved off the
+ * current chunk in order and are only ever released all at once, by
+ * arena_reset or arena_free. A whole file's task sets cost a malloc per
+ * chunk rather than one per set, and as a reset keeps the chunks, an arena
+ * refilled set after set stops calling malloc once it has held the largest
+ * and its footprint stays flat.
+ */
+
+// Default chunk size, allocations larger than a chunk get their own
+#define ARENA_CHUNK_SIZE (1 << 20)
+
+// Every allocation starts on this boundary
+#define ARENA_ALIGN 16
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena {
+
+    ArenaChunk *first;
+    ArenaChunk *current;
+    size_t chunk_size;
+
+} Arena;
+
+void arena_init(Arena *arena, size_t chunk_size);
+
+// Returns size bytes aligned to ARENA_ALIGN, or NULL if out of memory
+void *arena_alloc(Arena *arena, size_t size);
+
+// Releases every allocation and keeps the chunks for reuse
+void arena_reset(Arena *arena);
+
+// Releases the chunks too, the arena can be used again afterwards
+void arena_free(Arena *arena);
+
+#endif //ARENA_H
@@ -0,0 +1,238 @@
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "batch.h"
+#include "../rta/blocking.h"
+#include "../rta/rta.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_KERNELS 1
+#endif
+
+/*
+ * Sums of one batch, lane s being set s. Tasks are stored row by row,
+ * task t of set s at [t * BATCH_SETS + s].
+ */
+typedef struct BatchSums {
+
+    double utilization[BATCH_SETS];
+
+    // C_i / min(D_i, P_i) over tasks with work, as EDF has it
+    double density[BATCH_SETS];
+
+    // The same over every task, and ∏ (u_i + 1), as the bounds have them
+    double bound_density[BATCH_SETS];
+    double product[BATCH_SETS];
+
+    // 1 while every window min(D_i, P_i) equals the period, and the
+    // deadline, in which case the RM and DM orders are sorted by window
+    double period_windows[BATCH_SETS];
+    double deadline_windows[BATCH_SETS];
+
+} BatchSums;
+
+typedef void (*batch_kernel_fn)(const double *wcet, const double *period, const double *deadline,
+                                unsigned int rows, BatchSums *sums);
+
+static batch_kernel_fn selected;
+static pthread_once_t selected_once = PTHREAD_ONCE_INIT;
+
+// Every row in input order, so each lane's utilization and density come out
+// bit for bit as the scalar analyses sum them
+static void batch_scalar(const double *wcet, const double *period, const double *deadline,
+                         unsigned int rows, BatchSums *sums) {
+
+    for (unsigned int s = 0; s < BATCH_SETS; s++) {
+
+        double utilization = 0.0, density = 0.0, bound_density = 0.0, product = 1.0;
+        int period_windows = 1, deadline_windows = 1;
+
+        for (unsigned int t = 0; t < rows; t++) {
+            unsigned int k = t * BATCH_SETS + s;
+            double window = fmin(deadline[k], period[k]);
+            double u = wcet[k] / window;
+            utilization += wcet[k] / period[k];
+            if (wcet[k] > 0) {
+                density += u;
+            }
+            bound_density += u;
+            product *= u + 1.0;
+            period_windows &= window == period[k];
+            deadline_windows &= window == deadline[k];
+        }
+
+        sums->utilization[s] = utilization;
+        sums->density[s] = density;
+        sums->bound_density[s] = bound_density;
+        sums->product[s] = product;
+        sums->period_windows[s] = period_windows;
+        sums->deadline_windows[s] = deadline_windows;
+    }
+}
+
+#ifdef HAVE_X86_KERNELS
+
+__attribute__((target("avx2")))
+static void batch_avx2(const double *wcet, const double *period, const double *deadline,
+                       unsigned int rows, BatchSums *sums) {
+
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    // Two vectors of four lanes each
+    __m256d utilization[2] = {zero, zero}, density[2] = {zero, zero};
+    __m256d bound_density[2] = {zero, zero}, product[2] = {one, one};
+    __m256d period_windows[2] = {all, all}, deadline_windows[2] = {all, all};
+
+    for (unsigned int t = 0; t < rows; t++) {
+        for (unsigned int h = 0; h < 2; h++) {
+
+            unsigned int k = t * BATCH_SETS + 4 * h;
+            __m256d c = _mm256_loadu_pd(&wcet[k]);
+            __m256d p = _mm256_loadu_pd(&period[k]);
+            __m256d d = _mm256_loadu_pd(&deadline[k]);
+
+            __m256d window = _mm256_min_pd(d, p);
+            __m256d u = _mm256_div_pd(c, window);
+
+            utilization[h] = _mm256_add_pd(utilization[h], _mm256_div_pd(c, p));
+            density[h] = _mm256_add_pd(density[h], _mm256_and_pd(_mm256_cmp_pd(c, zero, _CMP_GT_OQ), u));
+            bound_density[h] = _mm256_add_pd(bound_density[h], u);
+            product[h] = _mm256_mul_pd(product[h], _mm256_add_pd(u, one));
+            period_windows[h] = _mm256_and_pd(period_windows[h], _mm256_cmp_pd(window, p, _CMP_EQ_OQ));
+            deadline_windows[h] = _mm256_and_pd(deadline_windows[h], _mm256_cmp_pd(window, d, _CMP_EQ_OQ));
+        }
+    }
+
+    for (unsigned int h = 0; h < 2; h++) {
+        _mm256_storeu_pd(&sums->utilization[4 * h], utilization[h]);
+        _mm256_storeu_pd(&sums->density[4 * h], density[h]);
+        _mm256_storeu_pd(&sums->bound_density[4 * h], bound_density[h]);
+        _mm256_storeu_pd(&sums->product[4 * h], product[h]);
+
+        // Masks to 1.0 or 0.0 like the scalar kernel's
+        _mm256_storeu_pd(&sums->period_windows[4 * h], _mm256_and_pd(period_windows[h], one));
+        _mm256_storeu_pd(&sums->deadline_windows[4 * h], _mm256_and_pd(deadline_windows[h], one));
+    }
+
+    _mm256_zeroupper();
+}
+
+#endif
+
+static void select_default(void) {
+
+    selected = batch_scalar;
+#ifdef HAVE_X86_KERNELS
+    if (__builtin_cpu_supports("avx2")) {
+        selected = batch_avx2;
+    }
+#endif
+}
+
+// Accepted by Liu & Layland or the hyperbolic bound as rta_bound_schedulable takes them, clear by the margin
+static int within_bounds(double density, double product, unsigned int n) {
+
+    double liu_layland = n * (exp2(1.0 / n) - 1.0) - RTA_BOUND_MARGIN;
+    return n == 0 || density <= liu_layland * (1.0 - BATCH_BOUND_MARGIN)
+           || product <= (2.0 - RTA_BOUND_MARGIN) * (1.0 - BATCH_BOUND_MARGIN);
+}
+
+int batch_scratch_init(BatchScratch *scratch, unsigned int max_tasks) {
+
+    size_t n = (size_t) (max_tasks < BATCH_MAX_TASKS ? max_tasks : BATCH_MAX_TASKS) * BATCH_SETS + 1;
+
+    *scratch = (BatchScratch) {max_tasks < BATCH_MAX_TASKS ? max_tasks : BATCH_MAX_TASKS};
+    scratch->wcet = malloc(n * sizeof(double));
+    scratch->period = malloc(n * sizeof(double));
+    scratch->deadline = malloc(n * sizeof(double));
+
+    if (scratch->wcet == NULL || scratch->period == NULL || scratch->deadline == NULL) {
+        batch_scratch_free(scratch);
+        return -1;
+    }
+
+    return 0;
+}
+
+void batch_scratch_free(BatchScratch *scratch) {
+
+    free(scratch->wcet);
+    free(scratch->period);
+    free(scratch->deadline);
+    *scratch = (BatchScratch) {0};
+}
+
+void batch_sufficient(TaskSet *task_sets, unsigned int count, BatchScratch *scratch, analysis_results *results,
+                      unsigned char *decided) {
+
+    // Tasks of each lane's set, none for sets too large to lay out
+    unsigned int lanes[BATCH_SETS] = {0};
+    unsigned int rows = 0;
+
+    for (unsigned int s = 0; s < count; s++) {
+        lanes[s] = task_sets[s].num_tasks <= scratch->max_tasks ? task_sets[s].num_tasks : 0;
+        rows = lanes[s] > rows ? lanes[s] : rows;
+    }
+
+    double *wcet = scratch->wcet, *period = scratch->period, *deadline = scratch->deadline;
+
+    // Empty tasks with a window of 1 add exactly nothing to any sum
+    for (unsigned int s = 0; s < BATCH_SETS; s++) {
+        unsigned int n = lanes[s];
+        for (unsigned int t = 0; t < rows; t++) {
+            unsigned int k = t * BATCH_SETS + s;
+            Task *task = t < n ? &task_sets[s].tasks[t] : NULL;
+            wcet[k] = task != NULL ? task->wcet : 0.0;
+            period[k] = task != NULL ? task->period : 1.0;
+            deadline[k] = task != NULL ? task->deadline : 1.0;
+        }
+    }
+
+    pthread_once(&selected_once, select_default);
+
+    BatchSums sums;
+    selected(wcet, period, deadline, rows, &sums);
+
+    for (unsigned int s = 0; s < count; s++) {
+
+        analysis_results *result = &results[s * NUM_FUSED_RESULTS];
+        unsigned char *known = &decided[s * NUM_FUSED_RESULTS];
+        double utilization = sums.utilization[s];
+
+        if (lanes[s] != task_sets[s].num_tasks) {
+            for (unsigned int r = 0; r < NUM_FUSED_RESULTS; r++) {
+                known[r] = 0;
+            }
+            continue;
+        }
+
+        // Processor is overloaded, no scheduler can work
+        if (utilization > 1.0) {
+            for (unsigned int r = 0; r < NUM_FUSED_RESULTS; r++) {
+                result[r] = (analysis_results) {0, utilization, TIER_UTILIZATION};
+                known[r] = 1;
+            }
+            continue;
+        }
+
+        known[FUSED_EDF] = sums.density[s] <= 1.0;
+        if (known[FUSED_EDF]) {
+            result[FUSED_EDF] = (analysis_results) {1, utilization, TIER_BOUND};
+        }
+
+        int bounded = !blocking_applies(&task_sets[s])
+                      && within_bounds(sums.bound_density[s], sums.product[s], task_sets[s].num_tasks);
+
+        known[FUSED_RM] = bounded && sums.period_windows[s] != 0.0;
+        known[FUSED_DM] = bounded && sums.deadline_windows[s] != 0.0;
+        for (unsigned int r = FUSED_RM; r <= FUSED_DM; r++) {
+            if (known[r]) {
+                result[r] = (analysis_results) {1, utilization, TIER_BOUND};
+            }
+        }
+    }
+}
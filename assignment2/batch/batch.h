@@ -0,0 +1,51 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "../task_types.h"
+#include "../fused/fused.h"
+
+// Task sets the sufficient tests look at together, one per vector lane
+#define BATCH_SETS 8
+
+// Larger sets are left to the analyses, the batch is laid out in a BatchScratch
+#define BATCH_MAX_TASKS 1024
+
+// Relative distance from a bound inside which the order of the sums matters
+#define BATCH_BOUND_MARGIN 1e-9
+
+// Room to lay out a batch, reused from batch to batch by one thread
+typedef struct BatchScratch {
+
+    unsigned int max_tasks;
+    double *wcet;
+    double *period;
+    double *deadline;
+
+} BatchScratch;
+
+// Sized for sets of up to max_tasks tasks, at most BATCH_MAX_TASKS. Returns 0, or -1 if out of memory
+int batch_scratch_init(BatchScratch *scratch, unsigned int max_tasks);
+void batch_scratch_free(BatchScratch *scratch);
+
+/*
+ * Cheap tests of up to BATCH_SETS task sets at once. The sets are laid out
+ * task by task with one set per lane, shorter sets padded with empty tasks,
+ * and every set's utilization, density and Liu & Layland and hyperbolic
+ * bound sums are built up side by side, with AVX2 where the CPU has it.
+ *
+ * results and decided hold NUM_FUSED_RESULTS entries per set, in the order
+ * of FusedResult. Where decided is 1 the result is exactly what edf_analysis,
+ * rm_analysis or dm_analysis would return: a rejection for U > 1, or an
+ * acceptance by the density or a bound. Where it's 0 the result is left
+ * alone and the set needs that analysis run on it.
+ *
+ * The bound sums come out in input order rather than in priority order as
+ * in rta_bound_schedulable, so sets within BATCH_BOUND_MARGIN of the bounds
+ * it takes, RTA_BOUND_MARGIN in, are left undecided, as are RM and DM for
+ * sets whose priority order isn't plainly sorted by min(D_i, P_i) and sets
+ * with blocking. So are sets larger than scratch->max_tasks.
+ */
+void batch_sufficient(TaskSet *task_sets, unsigned int count, BatchScratch *scratch, analysis_results *results,
+                      unsigned char *decided);
+
+#endif //BATCH_H
@@ -0,0 +1,248 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../task_types.h"
+#include "../admission/admission.h"
+#include "../edf/edf.h"
+#include "../rm/rm.h"
+#include "../dm/dm.h"
+#include "../rta/rta.h"
+#include "../generator/generator.h"
+
+/*
+ * Replays random sequences of admissions and removals against the admission
+ * library and checks every answer against the batch analyses on the same
+ * tasks. The tasks admitted so far are kept in admission order, which is
+ * the input order that breaks priority ties the way ts_try_add does, and
+ * after every step
+ *
+ *     - ts_try_add must agree with edf_analysis, rm_analysis or dm_analysis
+ *       of the admitted tasks plus the new one
+ *     - ts_query must give every admitted task the priority and, under RM
+ *       and DM, bit for bit the response time rta_response_times gives it
+ *     - ts_size and ts_utilization must match the admitted tasks
+ *
+ * Prints one line per policy with the operations done and the mismatches,
+ * and exits with 1 if there were any.
+ */
+
+// Most tasks admitted at once, adds are skipped while this many are in
+#define MAX_LIVE 64
+
+typedef struct ReplayOptions {
+
+    unsigned runs;
+    unsigned steps;
+    uint64_t seed;
+
+} ReplayOptions;
+
+typedef struct LiveTask {
+
+    unsigned int id;
+    Task task;
+
+} LiveTask;
+
+typedef struct ReplayCounts {
+
+    unsigned long adds;
+    unsigned long admitted;
+    unsigned long removes;
+    unsigned long mismatches;
+
+} ReplayCounts;
+
+static const char *policy_names[] = {"edf", "rm", "dm"};
+
+/*
+ *  FORWARD DECLARATIONS
+ */
+
+ReplayOptions parseReplayOptions(int argc, char *argv[]);
+void replay(AdmissionPolicy policy, ReplayOptions *options, unsigned run, ReplayCounts *counts);
+Task randomTask(Rng *rng);
+int analyze(AdmissionPolicy policy, TaskSet *task_set);
+unsigned long checkSystem(TaskSystem *system, AdmissionPolicy policy, LiveTask *live, unsigned int n,
+                          unsigned run, unsigned step);
+
+/*
+ *  Function Bodies
+ */
+
+int main(int argc, char *argv[]) {
+
+    ReplayOptions options = parseReplayOptions(argc, argv);
+    unsigned long mismatches = 0;
+
+    for (AdmissionPolicy policy = ADMISSION_EDF; policy <= ADMISSION_DM; policy++) {
+
+        ReplayCounts counts = {0};
+        for (unsigned run = 0; run < options.runs; run++) {
+            replay(policy, &options, run, &counts);
+        }
+
+        printf("%-3s adds %lu  admitted %lu  removes %lu  mismatches %lu\n", policy_names[policy],
+               counts.adds, counts.admitted, counts.removes, counts.mismatches);
+        mismatches += counts.mismatches;
+    }
+
+    return mismatches > 0;
+}
+
+ReplayOptions parseReplayOptions(int argc, char *argv[]) {
+
+    ReplayOptions options = {200, 300, 1};
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:s:R:")) != -1) {
+        switch (opt) {
+            case 'r':
+                options.runs = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                options.steps = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'R':
+                options.seed = strtoull(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-r runs] [-s steps per run] [-R seed]\n", argv[0]);
+                exit(-1);
+        }
+    }
+
+    return options;
+}
+
+// One run of options->steps random operations on a fresh system
+void replay(AdmissionPolicy policy, ReplayOptions *options, unsigned run, ReplayCounts *counts) {
+
+    TaskSystem *system = ts_create(policy);
+    LiveTask live[MAX_LIVE];
+    Task tasks[MAX_LIVE + 1];
+    unsigned int n = 0;
+    Rng rng;
+
+    rng_seed(&rng, options->seed, (uint64_t) policy * options->runs + run);
+
+    for (unsigned step = 0; step < options->steps; step++) {
+
+        // A third of the steps remove a random task, once there are any
+        if (n > 0 && (rng_uniform(&rng) < 1.0 / 3 || n == MAX_LIVE)) {
+
+            unsigned int k = (unsigned int) (rng_uniform(&rng) * n);
+            if (ts_remove(system, live[k].id) != 0) {
+                fprintf(stderr, "%s run %u step %u: ts_remove refused task %u\n",
+                        policy_names[policy], run, step, live[k].id);
+                counts->mismatches++;
+            }
+            memmove(&live[k], &live[k + 1], (n - k - 1) * sizeof(LiveTask));
+            n--;
+            counts->removes++;
+
+        } else {
+
+            Task task = randomTask(&rng);
+            for (unsigned int i = 0; i < n; i++) {
+                tasks[i] = live[i].task;
+            }
+            tasks[n] = task;
+            TaskSet task_set = {n + 1, tasks, NULL};
+
+            unsigned int id;
+            int admitted = ts_try_add(system, task, &id);
+            int expected = analyze(policy, &task_set);
+            if (admitted != expected) {
+                fprintf(stderr, "%s run %u step %u: ts_try_add gave %d for %u tasks, the analysis %d\n",
+                        policy_names[policy], run, step, admitted, n + 1, expected);
+                counts->mismatches++;
+            }
+            if (admitted) {
+                live[n++] = (LiveTask) {id, task};
+                counts->admitted++;
+            }
+            counts->adds++;
+        }
+
+        counts->mismatches += checkSystem(system, policy, live, n, run, step);
+    }
+
+    ts_free(system);
+}
+
+// Periods of 1 to 100, utilizations up to 0.3 and deadlines from 0.3 to 1.3 periods
+Task randomTask(Rng *rng) {
+
+    Task task;
+    task.period = 1 + floor(rng_uniform(rng) * 100);
+    task.wcet = floor(rng_uniform(rng) * 30 * task.period) / 100;
+    task.deadline = floor((0.3 + rng_uniform(rng)) * task.period * 100) / 100;
+    return task;
+}
+
+int analyze(AdmissionPolicy policy, TaskSet *task_set) {
+
+    switch (policy) {
+        case ADMISSION_RM:
+            return rm_analysis(task_set).is_schedulable;
+        case ADMISSION_DM:
+            return dm_analysis(task_set).is_schedulable;
+        default:
+            return edf_analysis(task_set).is_schedulable;
+    }
+}
+
+// Returns the number of ways ts_query, ts_size and ts_utilization disagree with the batch analyses
+unsigned long checkSystem(TaskSystem *system, AdmissionPolicy policy, LiveTask *live, unsigned int n,
+                          unsigned run, unsigned step) {
+
+    Task tasks[MAX_LIVE + 1];
+    unsigned int index[MAX_LIVE + 1];
+    double response[MAX_LIVE + 1];
+    double utilization = 0.0;
+    unsigned long mismatches = 0;
+
+    for (unsigned int i = 0; i < n; i++) {
+        tasks[i] = live[i].task;
+        utilization += tasks[i].wcet / tasks[i].period;
+    }
+    TaskSet task_set = {n, tasks, NULL};
+
+    PriorityOrder order = policy == ADMISSION_RM ? PRIORITY_BY_PERIOD : PRIORITY_BY_DEADLINE;
+    priority_order(index, &task_set, order);
+    if (policy != ADMISSION_EDF) {
+        rta_response_times(&task_set, order, response);
+    }
+
+    for (unsigned int k = 0; k < n; k++) {
+
+        unsigned int i = index[k];
+        TaskStatus status;
+
+        if (ts_query(system, live[i].id, &status) != 0 || status.priority != k) {
+            fprintf(stderr, "%s run %u step %u: task %u isn't found at priority %u\n",
+                    policy_names[policy], run, step, live[i].id, k);
+            mismatches++;
+            continue;
+        }
+
+        double expected = policy == ADMISSION_EDF ? NAN : response[i];
+        if (isnan(expected) ? !isnan(status.response) : status.response != expected) {
+            fprintf(stderr, "%s run %u step %u: task %u has response time %.17g, the analysis %.17g\n",
+                    policy_names[policy], run, step, live[i].id, status.response, expected);
+            mismatches++;
+        }
+    }
+
+    if (ts_size(system) != n || fabs(ts_utilization(system) - utilization) > 1e-9) {
+        fprintf(stderr, "%s run %u step %u: ts_size %u and ts_utilization %g for %u tasks of utilization %g\n",
+                policy_names[policy], run, step, ts_size(system), ts_utilization(system), n, utilization);
+        mismatches++;
+    }
+
+    return mismatches;
+}
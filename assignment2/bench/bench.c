@@ -0,0 +1,450 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "../task_types.h"
+#include "../edf/edf.h"
+#include "../rm/rm.h"
+#include "../dm/dm.h"
+#include "../opa/opa.h"
+#include "../fused/fused.h"
+#include "../generator/generator.h"
+#include "../ticks/ticks.h"
+#include "../instrument/instrument.h"
+
+/*
+ * Microbenchmark of the analyses. For every combination of task count,
+ * total utilization and deadline range it generates a batch of task sets,
+ * runs each selected algorithm over the whole batch a number of times and
+ * prints one CSV row per algorithm and combination:
+ *
+ *     algorithm,tasks,utilization,deadlines,sets,repetitions,
+ *     ns_per_set_min,ns_per_set_median,cache_misses_per_set,
+ *     instructions_per_set,iterations_per_set,checkpoints_per_set,schedulable
+ *
+ * Counter columns are empty where perf events aren't available. Iterations
+ * (RM and DM response-time iterations or scheduling points) and checkpoints
+ * (EDF deadlines and QPA steps) come from the analyses' own counters, counted
+ * over the untimed pass, and are empty in builds without ANALYSIS_STATS. Sets come
+ * from the in-process generator with a fixed seed, so two builds see exactly
+ * the same input and their rows can be compared directly.
+ */
+
+#define MAX_LIST 16
+
+typedef struct BenchAlgorithm {
+
+    const char *name;
+    analysis_fn analyze;
+
+} BenchAlgorithm;
+
+/*
+ * EDF, RM and DM one after another as main runs them, and the same through
+ * fused_analysis. is_schedulable counts the schedulable verdicts of the
+ * three, so both give the same schedulable column.
+ */
+static analysis_results separate_analyses(TaskSet *task_set) {
+
+    analysis_results results = edf_analysis(task_set);
+    results.is_schedulable += rm_analysis(task_set).is_schedulable;
+    results.is_schedulable += dm_analysis(task_set).is_schedulable;
+    return results;
+}
+
+static analysis_results fused_analyses(TaskSet *task_set) {
+
+    analysis_results results[NUM_FUSED_RESULTS];
+    fused_analysis(task_set, results);
+
+    results[FUSED_EDF].is_schedulable += results[FUSED_RM].is_schedulable + results[FUSED_DM].is_schedulable;
+    return results[FUSED_EDF];
+}
+
+static const BenchAlgorithm bench_algorithms[] = {
+    {"edf"        , edf_analysis              },
+    {"rm"         , rm_analysis               },
+    {"dm"         , dm_analysis               },
+    {"edf-forward", edf_forward_analysis      },
+    {"edf-ticks"  , edf_analysis_ticks        },
+    {"rm-ticks"   , rm_analysis_ticks         },
+    {"dm-ticks"   , dm_analysis_ticks         },
+    {"opa"        , opa_analysis              },
+    {"all"        , separate_analyses         },
+    {"fused"      , fused_analyses            },
+};
+
+#define NUM_BENCH_ALGORITHMS (sizeof(bench_algorithms) / sizeof(bench_algorithms[0]))
+
+typedef struct BenchOptions {
+
+    unsigned tasks[MAX_LIST];
+    unsigned num_tasks;
+
+    // Generator utilization levels, 0 for 0.05 up to 9 for 0.95
+    unsigned levels[MAX_LIST];
+    unsigned num_levels;
+
+    DeadlineRange deadlines[2];
+    unsigned num_deadlines;
+
+    const BenchAlgorithm *algorithms[NUM_BENCH_ALGORITHMS];
+    unsigned num_algorithms;
+
+    unsigned sets;
+    unsigned repetitions;
+    uint64_t seed;
+
+} BenchOptions;
+
+// Hardware counters around one timed run, fd -1 where unavailable
+typedef struct Counters {
+
+    int cache_misses;
+    int instructions;
+
+} Counters;
+
+/*
+ *  FORWARD DECLARATIONS
+ */
+
+BenchOptions parseBenchOptions(int argc, char *argv[]);
+unsigned parseList(char *text, unsigned *values, const char *what);
+ProgramInfo generateBatch(BenchOptions *options, unsigned tasks, unsigned level, DeadlineRange deadlines);
+void freeBatch(ProgramInfo *program);
+void runBenchmark(BenchOptions *options, const BenchAlgorithm *algorithm, ProgramInfo *program,
+                  Counters *counters, const char *label);
+Counters openCounters(void);
+void startCounters(Counters *counters);
+long long stopCounter(int fd);
+int compareDoubles(const void *a, const void *b);
+double now(void);
+
+/*
+ *  Function Bodies
+ */
+
+int main(int argc, char *argv[]) {
+
+    BenchOptions options = parseBenchOptions(argc, argv);
+    Counters counters = openCounters();
+
+    printf("algorithm,tasks,utilization,deadlines,sets,repetitions,ns_per_set_min,"
+           "ns_per_set_median,cache_misses_per_set,instructions_per_set,iterations_per_set,"
+           "checkpoints_per_set,schedulable\n");
+
+    for (unsigned t = 0; t < options.num_tasks; t++) {
+        for (unsigned u = 0; u < options.num_levels; u++) {
+            for (unsigned d = 0; d < options.num_deadlines; d++) {
+
+                ProgramInfo program = generateBatch(&options, options.tasks[t], options.levels[u],
+                                                    options.deadlines[d]);
+
+                char label[64];
+                snprintf(label, sizeof(label), "%u,%.2f,%s", options.tasks[t],
+                         0.05 + 0.1 * options.levels[u],
+                         options.deadlines[d] == DEADLINES_TIGHT ? "tight" : "wide");
+
+                for (unsigned a = 0; a < options.num_algorithms; a++) {
+                    runBenchmark(&options, options.algorithms[a], &program, &counters, label);
+                }
+
+                freeBatch(&program);
+            }
+        }
+    }
+
+    return 0;
+}
+
+BenchOptions parseBenchOptions(int argc, char *argv[]) {
+
+    BenchOptions options = {
+        .tasks = {10, 25}, .num_tasks = 2,
+        .levels = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}, .num_levels = GENERATOR_UTILIZATION_LEVELS,
+        .deadlines = {DEADLINES_WIDE, DEADLINES_TIGHT}, .num_deadlines = 2,
+        .algorithms = {&bench_algorithms[0], &bench_algorithms[1], &bench_algorithms[2]},
+        .num_algorithms = 3,
+        .sets = 2000, .repetitions = 5, .seed = 1,
+    };
+
+    unsigned percents[MAX_LIST];
+    char *name;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:u:D:a:s:r:R:")) != -1) {
+        switch (opt) {
+            case 'n':
+                options.num_tasks = parseList(optarg, options.tasks, "task count");
+                break;
+            case 'u':
+                // Utilizations in percent, rounded to the generator's levels
+                options.num_levels = parseList(optarg, percents, "utilization");
+                for (unsigned i = 0; i < options.num_levels; i++) {
+                    options.levels[i] = percents[i] >= 95 ? 9 : percents[i] / 10;
+                }
+                break;
+            case 'D':
+                options.num_deadlines = 0;
+                for (name = strtok(optarg, ","); name != NULL && options.num_deadlines < 2;
+                     name = strtok(NULL, ",")) {
+                    if (generator_parse_deadlines(name, &options.deadlines[options.num_deadlines++]) != 0) {
+                        fprintf(stderr, "%s: unknown deadline range '%s'\n", argv[0], name);
+                        exit(-1);
+                    }
+                }
+                break;
+            case 'a':
+                options.num_algorithms = 0;
+                for (name = strtok(optarg, ","); name != NULL; name = strtok(NULL, ",")) {
+                    unsigned a = 0;
+                    while (a < NUM_BENCH_ALGORITHMS && strcmp(bench_algorithms[a].name, name) != 0) {
+                        a++;
+                    }
+                    if (a == NUM_BENCH_ALGORITHMS || options.num_algorithms == NUM_BENCH_ALGORITHMS) {
+                        fprintf(stderr, "%s: unknown algorithm '%s'\n", argv[0], name);
+                        exit(-1);
+                    }
+                    options.algorithms[options.num_algorithms++] = &bench_algorithms[a];
+                }
+                break;
+            case 's':
+                options.sets = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'r':
+                options.repetitions = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'R':
+                options.seed = strtoull(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n tasks,...] [-u percent,...] [-D wide,tight] "
+                                "[-a algorithm,...] [-s sets] [-r repetitions] [-R seed]\n", argv[0]);
+                exit(-1);
+        }
+    }
+
+    if (options.sets == 0 || options.repetitions == 0) {
+        fprintf(stderr, "%s: -s and -r must be positive\n", argv[0]);
+        exit(-1);
+    }
+
+    return options;
+}
+
+// Parses a comma separated list of positive integers into values
+unsigned parseList(char *text, unsigned *values, const char *what) {
+
+    unsigned count = 0;
+
+    for (char *item = strtok(text, ","); item != NULL; item = strtok(NULL, ",")) {
+        unsigned long value = strtoul(item, NULL, 10);
+        if (count == MAX_LIST || value == 0) {
+            fprintf(stderr, "bad %s list\n", what);
+            exit(-1);
+        }
+        values[count++] = (unsigned) value;
+    }
+
+    return count;
+}
+
+/*
+ * Generates options->sets sets at one utilization level. They are the sets
+ * the generator would produce at that level for a run of ten times as many,
+ * ticks included so the tick algorithms can run on the same batch.
+ */
+ProgramInfo generateBatch(BenchOptions *options, unsigned tasks, unsigned level, DeadlineRange deadlines) {
+
+    GeneratorConfig config = {options->sets * GENERATOR_UTILIZATION_LEVELS, tasks, deadlines,
+                              options->seed};
+    ProgramInfo program = {options->sets, malloc(options->sets * sizeof(TaskSet))};
+
+    Task *task_array = malloc((size_t) options->sets * tasks * sizeof(Task));
+    TaskTicks *ticks_array = malloc((size_t) options->sets * tasks * sizeof(TaskTicks));
+    Rng rng;
+
+    for (unsigned i = 0; i < options->sets; i++) {
+
+        TaskSet *task_set = &program.task_sets[i];
+        task_set->num_tasks = tasks;
+        task_set->tasks = task_array + (size_t) i * tasks;
+        task_set->ticks = ticks_array + (size_t) i * tasks;
+
+        unsigned bad_task;
+        generate_task_set(&config, level * options->sets + i, &rng, task_set->tasks);
+        ticks_convert(task_set, task_set->ticks, &bad_task);
+    }
+
+    return program;
+}
+
+void freeBatch(ProgramInfo *program) {
+
+    free(program->task_sets[0].tasks);
+    free(program->task_sets[0].ticks);
+    free(program->task_sets);
+
+}
+
+void runBenchmark(BenchOptions *options, const BenchAlgorithm *algorithm, ProgramInfo *program,
+                  Counters *counters, const char *label) {
+
+    double seconds[options->repetitions];
+    long long cache_misses = -1, instructions = -1;
+    unsigned long iterations = 0, checkpoints = 0;
+    unsigned schedulable = 0;
+
+    // Untimed pass to warm caches and branch predictors, and the one the
+    // analyses count their work in so the timed passes don't pay for it
+    for (unsigned i = 0; i < program->num_task_sets; i++) {
+        AnalysisCounters counted;
+        instrument_begin(NULL, 0);
+        schedulable += algorithm->analyze(&program->task_sets[i]).is_schedulable;
+        instrument_end(&counted);
+        iterations += counted.iterations;
+        checkpoints += counted.checkpoints;
+    }
+
+    for (unsigned r = 0; r < options->repetitions; r++) {
+
+        // Counters cover the last repetition only
+        int counted = r + 1 == options->repetitions;
+        if (counted) {
+            startCounters(counters);
+        }
+
+        double start = now();
+        unsigned check = 0;
+        for (unsigned i = 0; i < program->num_task_sets; i++) {
+            check += algorithm->analyze(&program->task_sets[i]).is_schedulable;
+        }
+        seconds[r] = now() - start;
+
+        if (counted) {
+            cache_misses = stopCounter(counters->cache_misses);
+            instructions = stopCounter(counters->instructions);
+        }
+
+        if (check != schedulable) {
+            fprintf(stderr, "%s gave different verdicts between runs\n", algorithm->name);
+            exit(-1);
+        }
+    }
+
+    qsort(seconds, options->repetitions, sizeof(double), compareDoubles);
+    double sets = program->num_task_sets;
+
+    printf("%s,%s,%u,%u,%.1f,%.1f,", algorithm->name, label, program->num_task_sets,
+           options->repetitions, seconds[0] * 1e9 / sets,
+           seconds[options->repetitions / 2] * 1e9 / sets);
+
+    if (cache_misses >= 0) {
+        printf("%.2f", cache_misses / sets);
+    }
+    printf(",");
+    if (instructions >= 0) {
+        printf("%.1f", instructions / sets);
+    }
+    printf(",");
+    if (instrument_available()) {
+        printf("%.2f,%.2f", iterations / sets, checkpoints / sets);
+    } else {
+        printf(",");
+    }
+    printf(",%u\n", schedulable);
+    fflush(stdout);
+}
+
+#ifdef __linux__
+
+static int openCounter(unsigned long long config) {
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+Counters openCounters(void) {
+
+    Counters counters = {openCounter(PERF_COUNT_HW_CACHE_MISSES),
+                         openCounter(PERF_COUNT_HW_INSTRUCTIONS)};
+    return counters;
+
+}
+
+void startCounters(Counters *counters) {
+
+    int fds[] = {counters->cache_misses, counters->instructions};
+
+    for (unsigned i = 0; i < 2; i++) {
+        if (fds[i] >= 0) {
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+// Stops the counter and returns its count, or -1 if it isn't available
+long long stopCounter(int fd) {
+
+    long long count;
+
+    if (fd < 0) {
+        return -1;
+    }
+
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    return read(fd, &count, sizeof(count)) == sizeof(count) ? count : -1;
+}
+
+#else
+
+Counters openCounters(void) {
+
+    Counters counters = {-1, -1};
+    return counters;
+
+}
+
+void startCounters(Counters *counters) {
+}
+
+long long stopCounter(int fd) {
+
+    return -1;
+
+}
+
+#endif
+
+int compareDoubles(const void *a, const void *b) {
+
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+
+}
+
+double now(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+
+}
@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../task_types.h"
+#include "../dm/dm.h"
+#include "../opa/opa.h"
+#include "../rta/rta.h"
+#include "../generator/generator.h"
+
+/*
+ * Checks Audsley's assignment against the deadline monotonic analysis. For
+ * a few fixed corner cases and then every generated set
+ *
+ *     - opa_assign must accept every set dm_analysis accepts, as the DM
+ *       order is one of those it searches
+ *     - every order opa_assign returns must pass rta_schedulable
+ *
+ * The fixed cases cover tasks without any work, which the response time
+ * lower bounds opa_assign starts from don't hold for, a start just below a
+ * step of the recurrence, and a response time that only meets its deadline
+ * when the terms add up in task set order. Prints the sets checked and the
+ * mismatches, and exits with 1 if there were any.
+ */
+
+#define MAX_TASKS 256
+
+typedef struct CheckOptions {
+
+    GeneratorConfig config;
+
+} CheckOptions;
+
+typedef struct FixedCase {
+
+    const char *name;
+    unsigned int num_tasks;
+    Task tasks[3];
+
+} FixedCase;
+
+// WCET, deadline, period
+static const FixedCase fixed_cases[] = {
+    {"no work at all"     , 2, {{0, 0.34, 1}, {0, 0.2, 2.17}}},
+    {"no work, no slack"  , 2, {{1, 2, 2}, {0, 0, 1}}},
+    {"start below a step" , 2, {{0.18, 0.33, 0.41}, {0.92, 1.78, 8.96}}},
+    {"sum at the deadline", 3, {{0.41, 2.24, 8.94}, {1.09, 2.8, 8.2}, {0.65, 0.93, 1.76}}},
+};
+
+#define NUM_FIXED_CASES (sizeof(fixed_cases) / sizeof(fixed_cases[0]))
+
+/*
+ *  FORWARD DECLARATIONS
+ */
+
+CheckOptions parseCheckOptions(int argc, char *argv[]);
+unsigned long checkSet(TaskSet *task_set, const char *name, unsigned int index);
+int orderSchedulable(TaskSet *task_set, unsigned int *order);
+
+/*
+ *  Function Bodies
+ */
+
+int main(int argc, char *argv[]) {
+
+    CheckOptions options = parseCheckOptions(argc, argv);
+    GeneratorConfig *config = &options.config;
+    unsigned long mismatches = 0;
+
+    for (unsigned int i = 0; i < NUM_FIXED_CASES; i++) {
+        TaskSet task_set = {fixed_cases[i].num_tasks, (Task *) fixed_cases[i].tasks, NULL};
+        mismatches += checkSet(&task_set, fixed_cases[i].name, i);
+    }
+
+    Task tasks[MAX_TASKS + 1];
+    Rng rng;
+
+    for (unsigned int i = 0; i < config->num_task_sets; i++) {
+        generate_task_set(config, i, &rng, tasks);
+        TaskSet task_set = {config->num_tasks, tasks, NULL};
+        mismatches += checkSet(&task_set, "generated", i);
+    }
+
+    printf("fixed %u  generated %u  mismatches %lu\n", (unsigned) NUM_FIXED_CASES, config->num_task_sets,
+           mismatches);
+    return mismatches > 0;
+}
+
+CheckOptions parseCheckOptions(int argc, char *argv[]) {
+
+    CheckOptions options = {{20000, 25, DEADLINES_WIDE, 7}};
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:n:D:R:")) != -1) {
+        switch (opt) {
+            case 's':
+                options.config.num_task_sets = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                options.config.num_tasks = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+            case 'D':
+                if (generator_parse_deadlines(optarg, &options.config.deadlines) != 0) {
+                    fprintf(stderr, "Unknown deadline range '%s', use wide or tight\n", optarg);
+                    exit(-1);
+                }
+                break;
+            case 'R':
+                options.config.seed = strtoull(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-s sets] [-n tasks] [-D wide|tight] [-R seed]\n", argv[0]);
+                exit(-1);
+        }
+    }
+
+    if (options.config.num_tasks == 0 || options.config.num_tasks > MAX_TASKS) {
+        fprintf(stderr, "-n takes 1 to %u tasks\n", MAX_TASKS);
+        exit(-1);
+    }
+
+    return options;
+}
+
+// Returns the number of ways opa_assign disagrees with dm_analysis and its own order on task_set
+unsigned long checkSet(TaskSet *task_set, const char *name, unsigned int index) {
+
+    unsigned int order[MAX_TASKS + 1];
+    unsigned long mismatches = 0;
+
+    int opa = opa_assign(task_set, order).is_schedulable;
+    int dm = dm_analysis(task_set).is_schedulable;
+
+    if (dm && !opa) {
+        fprintf(stderr, "%s set %u: DM accepts it, OPA doesn't\n", name, index);
+        mismatches++;
+    }
+    if (opa && !orderSchedulable(task_set, order)) {
+        fprintf(stderr, "%s set %u: the order OPA gave fails response-time analysis\n", name, index);
+        mismatches++;
+    }
+
+    return mismatches;
+}
+
+// Response-time analysis of task_set with order[] from highest to lowest priority
+int orderSchedulable(TaskSet *task_set, unsigned int *order) {
+
+    PRIORITY_SET_ON_STACK(set, task_set->num_tasks);
+
+    for (unsigned int k = 0; k < task_set->num_tasks; k++) {
+        Task *task = &task_set->tasks[order[k]];
+        set.input[k] = order[k];
+        set.wcet[k] = task->wcet;
+        set.period[k] = task->period;
+        set.deadline[k] = task->deadline;
+        set.inv_period[k] = 1.0 / task->period;
+    }
+
+    return rta_schedulable(&set);
+}
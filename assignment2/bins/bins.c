@@ -0,0 +1,118 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bins.h"
+
+// Utilizations past this many bins share the last one
+#define MAX_BINS (1u << 20)
+
+void bins_init(UtilizationBins *bins, double width) {
+
+    bins->width = width;
+    bins->num_bins = 0;
+    bins->sets = NULL;
+    bins->schedulable = NULL;
+
+}
+
+void bins_free(UtilizationBins *bins) {
+
+    free(bins->sets);
+    free(bins->schedulable);
+    bins_init(bins, bins->width);
+
+}
+
+static void grow(UtilizationBins *bins, unsigned int num_bins) {
+
+    unsigned int capacity = bins->num_bins ? bins->num_bins : 16;
+    while (capacity < num_bins) {
+        capacity *= 2;
+    }
+
+    bins->sets = realloc(bins->sets, capacity * sizeof(unsigned long));
+    bins->schedulable = realloc(bins->schedulable, capacity * sizeof(unsigned long));
+
+    memset(bins->sets + bins->num_bins, 0, (capacity - bins->num_bins) * sizeof(unsigned long));
+    memset(bins->schedulable + bins->num_bins, 0, (capacity - bins->num_bins) * sizeof(unsigned long));
+    bins->num_bins = capacity;
+}
+
+static unsigned int bin_index(double width, double utilization) {
+
+    if (!(utilization > 0.0)) {
+        return 0;
+    }
+
+    double index = floor(utilization / width);
+    if (index >= MAX_BINS - 1) {
+        return MAX_BINS - 1;
+    }
+
+    // The division can land either side of an edge, compare with the edges themselves
+    unsigned int k = (unsigned int) index;
+    if ((k + 1) * width <= utilization) {
+        k++;
+    } else if (k > 0 && k * width > utilization) {
+        k--;
+    }
+
+    return k;
+}
+
+void bins_add(UtilizationBins *bins, double utilization, int is_schedulable) {
+
+    unsigned int k = bin_index(bins->width, utilization);
+
+    if (k >= bins->num_bins) {
+        grow(bins, k + 1);
+    }
+
+    bins->sets[k]++;
+    bins->schedulable[k] += is_schedulable != 0;
+}
+
+void bins_merge(UtilizationBins *dst, const UtilizationBins *src) {
+
+    if (src->num_bins > dst->num_bins) {
+        grow(dst, src->num_bins);
+    }
+
+    for (unsigned int k = 0; k < src->num_bins; k++) {
+        dst->sets[k] += src->sets[k];
+        dst->schedulable[k] += src->schedulable[k];
+    }
+}
+
+void bins_write(FILE *file, const UtilizationBins *bins, const char *const *names, unsigned count) {
+
+    fprintf(file, "# low high sets");
+    for (unsigned a = 0; a < count; a++) {
+        fprintf(file, " %s %s_pct", names[a], names[a]);
+    }
+    fprintf(file, "\n");
+
+    // Rows run up to the last bin anything fell in
+    unsigned int num_bins = 0;
+    for (unsigned a = 0; a < count; a++) {
+        for (unsigned int k = bins[a].num_bins; k > num_bins; k--) {
+            if (bins[a].sets[k - 1] != 0) {
+                num_bins = k;
+                break;
+            }
+        }
+    }
+
+    for (unsigned int k = 0; k < num_bins; k++) {
+
+        unsigned long sets = count > 0 && k < bins[0].num_bins ? bins[0].sets[k] : 0;
+        fprintf(file, "%.4f %.4f %lu", k * bins[0].width, (k + 1) * bins[0].width, sets);
+
+        for (unsigned a = 0; a < count; a++) {
+            unsigned long schedulable = k < bins[a].num_bins ? bins[a].schedulable[k] : 0;
+            fprintf(file, " %lu %.2f", schedulable, sets ? 100.0 * schedulable / sets : 0.0);
+        }
+        fprintf(file, "\n");
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef BINS_H
+#define BINS_H
+
+#include <stdio.h>
+
+/*
+ * Schedulable counts per utilization bin, kept while the analyses run so a
+ * sweep can be summarized without writing and re-reading per-set results.
+ * Bin k holds utilizations in [k * width, (k + 1) * width), with the edges
+ * computed the way numpy.arange computes them in create_graphs.py.
+ *
+ * Each worker keeps its own bins and they are merged at the end.
+ */
+
+typedef struct UtilizationBins {
+
+    double width;
+    unsigned int num_bins;
+    unsigned long *sets;
+    unsigned long *schedulable;
+
+} UtilizationBins;
+
+// Empty bins of the given width. Bins are added as utilizations need them
+void bins_init(UtilizationBins *bins, double width);
+void bins_free(UtilizationBins *bins);
+
+void bins_add(UtilizationBins *bins, double utilization, int is_schedulable);
+
+// Adds src's counts into dst, both of the same width
+void bins_merge(UtilizationBins *dst, const UtilizationBins *src);
+
+/*
+ * Writes one row per bin with the number of sets and, for each of the
+ * count bins, the number and percentage of schedulable sets
+ *
+ *     low high sets name1 name1_pct name2 name2_pct ...
+ *
+ * The bins must have been filled from the same task sets.
+ */
+void bins_write(FILE *file, const UtilizationBins *bins, const char *const *names, unsigned count);
+
+#endif //BINS_H
@@ -1,5 +1,8 @@
 #!/usr/bin/env python3
 
+import os
+import sys
+
 import matplotlib.pylab as plt
 import numpy as np
 
@@ -7,31 +10,52 @@ edf = "out/results_edf.txt"
 rm = "out/results_rm.txt"
 dm = "out/results_dm.txt"
 
+summary = "out/summary.txt"
+
 bins = np.arange(0, 1.1, .1)
 
+# A run with -b already binned the results, plot its summary table instead
+if os.path.exists(summary):
+
+    table = np.genfromtxt(summary, names=True)
+
+    for name in ["edf", "rm", "dm"]:
+        plt.plot((table["low"] + table["high"]) / 2, table[name + "_pct"] / 100, label=name)
+
+    plt.legend(loc="lower left")
+    plt.show()
+    sys.exit()
+
 for fi in [edf, rm, dm]:
 
-    # Create 2D structured numpy array from output file
-    results = np.genfromtxt(fi, delimiter=" ", dtype=[("sched", int  ),
-                                                      ("util" , float)])
+    # A run with -N wrote packed columns, map those instead of parsing text
+    columns = fi.replace(".txt", "_{}.npy")
+    if os.path.exists(columns.format("schedulable")):
+        sched = np.load(columns.format("schedulable"), mmap_mode="r")
+        util = np.load(columns.format("utilization"), mmap_mode="r")
+    else:
+        # Create 2D structured numpy array from output file
+        results = np.genfromtxt(fi, delimiter=" ", dtype=[("sched", int  ),
+                                                          ("util" , float)])
+        sched, util = results["sched"], results["util"]
 
     # Create array where each value is the bin at which the original list's
     # entry fits into. Values are floored to fit into bin (ie. 0.19 goes in the
     # 0.1 bin). This is why the bins are not 0.05, 0.15, 0.25, etc.
-    indices = np.digitize(results["util"], bins)
+    indices = np.digitize(util, bins)
 
     # Get the percent of schedulable task sets at each bin
     percents = []
     for bin_ in range(1, bins.size):
 
         # Get all results that are within current bin
-        filtered = results[np.where(indices == bin_)]
+        in_bin = indices == bin_
 
         # Count schedulable task sets (schedulable == 1, so sum works perfectly)
-        sched_count = (filtered["sched"]).sum()
+        sched_count = sched[in_bin].sum()
 
         # Add to list
-        percents.append(sched_count / filtered.size)
+        percents.append(sched_count / in_bin.sum())
 
     # Plot
     plt.plot(bins[:-1] + .05, percents, label=fi.split('_')[1].split('.')[0])
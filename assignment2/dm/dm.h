@@ -3,4 +3,7 @@
 
 analysis_results dm_analysis (TaskSet *task_set);
 
+// Exact analysis over task_set->ticks
+analysis_results dm_analysis_ticks (TaskSet *task_set);
+
 #endif //DM_H
@@ -1,34 +1,260 @@
 #include "../task_types.h"
+#include "../ticks/ticks.h"
+#include "../instrument/instrument.h"
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
 
-unsigned int for_some_index_less_than_or_equal(double *list, int size, double value)
+/*
+ * Processor demand analysis
+ *
+ *     The demand h(t) is the execution time of all jobs released at or after
+ *     the synchronous release at 0 whose deadlines are at or before t
+ *
+ *         h(t) = ∑(D_i <= t, (⌊(t - D_i)/P_i⌋ + 1) * C_i)
+ *
+ *     The set is schedulable iff h(t) <= t at every absolute deadline t
+ *     below L, the length of the synchronous busy period.
+ *
+ *     Notes taken from Zhang & Burns, "Schedulability Analysis for Real-Time
+ *     Systems with EDF Scheduling", IEEE Trans. Computers, 2009
+ */
+
+// Demand within this fraction of t counts as equal to t. Sums of two-decimal
+// values pick up rounding error, and a set whose demand exactly meets a
+// deadline would otherwise fail depending on summation order.
+#define DEMAND_EPSILON 1e-9
+
+static inline int exceeds(double demand, double time)
+{
+	return demand > time * (1.0 + DEMAND_EPSILON);
+}
+
+// Absolute deadline of job k of task t. Every deadline is computed with this
+// one expression so comparisons between deadlines and demand counts agree.
+static inline double job_deadline(Task *t, double k)
+{
+	return t->deadline + k * t->period;
+}
+
+// Number of jobs of t with absolute deadline <= time
+static inline double jobs_due_by(Task *t, double time)
+{
+	if(time < t->deadline){
+		return 0.0;
+	}
+
+	double k = floor((time - t->deadline) / t->period);
+
+	// Correct for rounding in the division
+	if(job_deadline(t, k + 1) <= time){
+		k += 1;
+	}else if(job_deadline(t, k) > time){
+		k -= 1;
+	}
+	return k + 1;
+}
+
+static double demand(TaskSet *task_set, double time)
 {
-	unsigned int ret = 0;
-	for(int i = 0; i < size; i++)
+	double h = 0.0;
+	for(int i = 0; i < task_set->num_tasks; i++)
 	{
-		ret |= (list[i] <= value);
+		Task *t = &(task_set->tasks[i]);
+		h += jobs_due_by(t, time) * t->wcet;
 	}
-	return ret;
+	return h;
 }
 
-unsigned int smallest_index(double *list, int size)
+// Latest absolute deadline strictly before time, or -1 if there is none
+static double deadline_before(TaskSet *task_set, double time)
 {
-	unsigned int index = 0;
-	for(int i = 0; i < size; i++)
+	double latest = -1.0;
+	for(int i = 0; i < task_set->num_tasks; i++)
 	{
-		if(list[i] < list[index]){
-			index = i;
+		Task *t = &(task_set->tasks[i]);
+		double k = jobs_due_by(t, time) - 1;
+
+		// Step back off a deadline that lands exactly on time
+		if(k >= 0 && job_deadline(t, k) >= time){
+			k -= 1;
+		}
+		if(k >= 0){
+			latest = fmax(latest, job_deadline(t, k));
 		}
 	}
-	return index;
+	return latest;
 }
 
-analysis_results edf_analysis (TaskSet *task_set)
+/*
+ * Length of the synchronous busy period, w_n+1 = ∑ ⌈w_n/P_i⌉ * C_i from
+ * w_0 = ∑ C_i. The ceilings only change when w crosses a period multiple and
+ * the sum is taken in the same order every time, so the fixed point is hit
+ * exactly. For U < 1 the iteration is cut off at Baruah's bound
+ *
+ *     L_a = max(D_max, ∑ (P_i - D_i) * U_i / (1 - U))
+ *
+ * which also bounds the deadlines that need checking.
+ */
+static double busy_period(TaskSet *task_set, double utilization)
+{
+	double bound = INFINITY;
+	if(utilization < 1.0)
+	{
+		double slack = 0.0;
+		bound = 0.0;
+		for(int i = 0; i < task_set->num_tasks; i++)
+		{
+			Task *t = &(task_set->tasks[i]);
+			bound = fmax(bound, t->deadline);
+			slack += (t->period - t->deadline) * t->wcet / t->period;
+		}
+		bound = fmax(bound, slack / (1.0 - utilization));
+	}
+
+	double l = 0.0;
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		l += task_set->tasks[i].wcet;
+	}
+
+	for(;;)
+	{
+		double new_l = 0.0;
+		for(int i = 0; i < task_set->num_tasks; i++)
+		{
+			Task *t = &(task_set->tasks[i]);
+			new_l += ceil(l / t->period) * t->wcet;
+		}
+
+		if(new_l == l){
+			return fmin(l, bound);
+		}
+		if(new_l > bound){
+			return bound;
+		}
+		l = new_l;
+	}
+}
+
+/*
+ * Quick Processor-demand Analysis. Rather than stepping forward through
+ * every deadline below L, walk backwards from the last one: whenever
+ * h(t) < t, no deadline in (h(t), t) can fail either, so jump straight to
+ * h(t). Only when h(t) == t is the next earlier deadline needed.
+ */
+static int qpa(TaskSet *task_set, double l)
+{
+	double d_min = INFINITY;
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		d_min = fmin(d_min, task_set->tasks[i].deadline);
+	}
+
+	double t = deadline_before(task_set, l);
+	if(t < 0){
+		// No deadline falls inside the busy period
+		return 1;
+	}
+
+	double h = demand(task_set, t);
+	INSTRUMENT_CHECKPOINT();
+	while(!exceeds(h, t) && exceeds(h, d_min))
+	{
+		if(exceeds(t, h)){
+			t = h;
+		}else{
+			t = deadline_before(task_set, t);
+			if(t < 0){
+				return 1;
+			}
+		}
+		h = demand(task_set, t);
+		INSTRUMENT_CHECKPOINT();
+	}
+
+	return !exceeds(h, d_min);
+}
+
+// Binary min-heap of next absolute deadlines, one entry per task
+typedef struct DeadlineHeap {
+	double *time;
+	int *task;
+	int size;
+} DeadlineHeap;
+
+static void heap_sift_down(DeadlineHeap *heap, int i)
+{
+	for(;;)
+	{
+		int smallest = i;
+		int left = 2 * i + 1, right = 2 * i + 2;
+		if(left < heap->size && heap->time[left] < heap->time[smallest]){
+			smallest = left;
+		}
+		if(right < heap->size && heap->time[right] < heap->time[smallest]){
+			smallest = right;
+		}
+		if(smallest == i){
+			return;
+		}
+
+		double time = heap->time[i];
+		int task = heap->task[i];
+		heap->time[i] = heap->time[smallest];
+		heap->task[i] = heap->task[smallest];
+		heap->time[smallest] = time;
+		heap->task[smallest] = task;
+		i = smallest;
+	}
+}
+
+/*
+ * Forward walk over every absolute deadline up to l in order, checking the
+ * accumulated demand at each. The nearest deadline comes off a heap, so a
+ * step costs O(log n).
+ */
+static int forward_walk(TaskSet *task_set, double l)
+{
+	int n = task_set->num_tasks;
+	double time[n + 1], jobs[n + 1];
+	int task[n + 1];
+	DeadlineHeap heap = {time, task, n};
+	double h = 0.0;
+
+	for(int i = 0; i < n; i++)
+	{
+		time[i] = task_set->tasks[i].deadline;
+		task[i] = i;
+		jobs[i] = 0.0;
+	}
+	for(int i = n / 2 - 1; i >= 0; i--)
+	{
+		heap_sift_down(&heap, i);
+	}
+
+	while(heap.size > 0 && heap.time[0] <= l)
+	{
+		Task *t = &(task_set->tasks[heap.task[0]]);
+		h += t->wcet;
+		INSTRUMENT_CHECKPOINT();
+		if(exceeds(h, heap.time[0])){
+			return 0;
+		}
+
+		// Replace the root with the task's next deadline
+		jobs[heap.task[0]] += 1.0;
+		heap.time[0] = job_deadline(t, jobs[heap.task[0]]);
+		heap_sift_down(&heap, 0);
+	}
+
+	return 1;
+}
+
+static analysis_results edf_demand_analysis(TaskSet *task_set, int (*check)(TaskSet *, double))
 {
 	// fprintf(stderr, "EDF\n");
-	analysis_results results = {0, 0.0};
+	analysis_results results = {0, 0.0, TIER_UTILIZATION};
 	double density = 0.0;
 
 	//get utilization
@@ -42,66 +268,265 @@ analysis_results edf_analysis (TaskSet *task_set)
 	for(int i = 0; i < task_set->num_tasks; i++)
 	{
 		Task *t = &(task_set->tasks[i]);
-		density += t->wcet / fmin(t->period, t->deadline);
+		// A task with no work adds nothing, even with a deadline of 0
+		if(t->wcet > 0){
+			density += t->wcet / fmin(t->period, t->deadline);
+		}
 	}
 
-	if(density > 1.0){
-		//get L value
-		double l;
-		{
-			l = 0.0;
-			for(int i = 0; i < task_set->num_tasks; i++)
-			{
-				l += task_set->tasks[i].wcet;
-			}
+	// Demand outgrows any interval, and the busy period never ends
+	if(results.utilization > 1.0){
+		return results;
+	}
 
-			double new_l = l;
-			do{
-				l = new_l;
-				new_l = 0.0;
-				for(int i = 0; i < task_set->num_tasks; i++)
-				{
-					Task *t = &(task_set->tasks[i]);
-					new_l += ceil(l / t->period) * t->wcet;
-				}
-			}while(l > (new_l * 1.01) || l < (new_l * 0.99));
+	results.tier = TIER_BOUND;
+	if(density > 1.0){
+		results.tier = TIER_EXACT;
+		double l = busy_period(task_set, results.utilization);
+		INSTRUMENT_BUSY_PERIOD(l);
+		if(!check(task_set, l)){
+			// fputs("Not Schedulable\n", stderr);
+			return results;
 		}
+	}
 
+	// fputs("Schedulable\n", stderr);
+	results.is_schedulable = 1;
+	return results;
+}
 
-		//get loading factor
-		// make array to keep track of time stamps for each task, initialize array to respective task deadlines
-		// make h variable, initialize to zero
-		// while some array value < l
-			// find smallest value in array, indicating nearest deadline
-			// increase h by that deadline's task's wcet
-			// check if utilization > 1.0. if so, return
-			// increase that task's next deadline by it's period
+int edf_demand_schedulable (TaskSet *task_set, double utilization)
+{
+	double l = busy_period(task_set, utilization);
+	INSTRUMENT_BUSY_PERIOD(l);
+	return qpa(task_set, l);
+}
 
-		double time_stamps[task_set->num_tasks];
-		double h;
+analysis_results edf_analysis (TaskSet *task_set)
+{
+	return edf_demand_analysis(task_set, qpa);
+}
+
+analysis_results edf_forward_analysis (TaskSet *task_set)
+{
+	return edf_demand_analysis(task_set, forward_walk);
+}
+
+/*
+ * Tick versions of the above. Demand, deadlines and the busy period are all
+ * exact integers, so there is no rounding to allow for.
+ */
+
+static inline ticks_t jobs_due_by_ticks(TaskTicks *t, ticks_t time)
+{
+	return time < t->deadline ? 0 : (time - t->deadline) / t->period + 1;
+}
+
+static ticks_t demand_ticks(TaskSet *task_set, ticks_t time)
+{
+	ticks_t h = 0;
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		TaskTicks *t = &(task_set->ticks[i]);
+		h += jobs_due_by_ticks(t, time) * t->wcet;
+	}
+	return h;
+}
+
+static ticks_t deadline_before_ticks(TaskSet *task_set, ticks_t time)
+{
+	ticks_t latest = -1;
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		TaskTicks *t = &(task_set->ticks[i]);
+		if(t->deadline < time){
+			ticks_t d = t->deadline + (time - 1 - t->deadline) / t->period * t->period;
+			latest = d > latest ? d : latest;
+		}
+	}
+	return latest;
+}
 
+// Least common multiple of the periods, or 0 if it doesn't fit
+static ticks_t hyperperiod_ticks(TaskSet *task_set)
+{
+	ticks_t h = 1;
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		ticks_t a = h, b = task_set->ticks[i].period;
+		while(b != 0){
+			ticks_t r = a % b;
+			a = b;
+			b = r;
+		}
+		ticks_t scale = task_set->ticks[i].period / a;
+		if(h > INT64_MAX / 4 / scale){
+			return 0;
+		}
+		h *= scale;
+	}
+	return h;
+}
+
+// See busy_period. utilization_cmp is ticks_compare_utilization's result
+static ticks_t busy_period_ticks(TaskSet *task_set, int utilization_cmp)
+{
+	ticks_t bound = INT64_MAX / 4;
+	if(utilization_cmp < 0)
+	{
+		long double utilization = 0.0L, slack = 0.0L;
+		ticks_t d_max = 0;
 		for(int i = 0; i < task_set->num_tasks; i++)
 		{
-			time_stamps[i] = task_set->tasks[i].deadline;
+			TaskTicks *t = &(task_set->ticks[i]);
+			utilization += (long double) t->wcet / t->period;
+			slack += (long double) (t->period - t->deadline) * t->wcet / t->period;
+			d_max = t->deadline > d_max ? t->deadline : d_max;
 		}
-		h = 0.0;
 
+		// Round the bound up generously, it only has to be at least L_a
+		long double l_a = ceill(slack / (1.0L - utilization) * (1.0L + 1e-12L)) + 1;
+		if(l_a < bound){
+			bound = (ticks_t) l_a > d_max ? (ticks_t) l_a : d_max;
+		}
+	}
+	else
+	{
+		// At U == 1 the busy period ends at the latest at the hyperperiod
+		ticks_t h = hyperperiod_ticks(task_set);
+		if(h > 0){
+			bound = h;
+		}
+	}
+
+	ticks_t l = 0;
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		l += task_set->ticks[i].wcet;
+	}
 
-		while(for_some_index_less_than_or_equal(time_stamps, task_set->num_tasks, l))
+	for(;;)
+	{
+		ticks_t new_l = 0;
+		for(int i = 0; i < task_set->num_tasks; i++)
 		{
-			unsigned int index = smallest_index(time_stamps, task_set->num_tasks);
-			h += task_set->tasks[index].wcet;
-			// printf("h:%lf\n", h);
-			// printf("t:%lf\n", time_stamps[index]);
-			if(h > time_stamps[index]){
-				// fputs("Not Schedulable\n", stderr);
-				return results;
+			TaskTicks *t = &(task_set->ticks[i]);
+			new_l += ticks_ceil_div(l, t->period) * t->wcet;
+		}
+
+		if(new_l == l){
+			return l < bound ? l : bound;
+		}
+		if(new_l > bound){
+			return bound;
+		}
+		l = new_l;
+	}
+}
+
+static int qpa_ticks(TaskSet *task_set, ticks_t l)
+{
+	ticks_t d_min = INT64_MAX;
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		d_min = ticks_min(d_min, task_set->ticks[i].deadline);
+	}
+
+	ticks_t t = deadline_before_ticks(task_set, l);
+	if(t < 0){
+		return 1;
+	}
+
+	ticks_t h = demand_ticks(task_set, t);
+	INSTRUMENT_CHECKPOINT();
+	while(h <= t && h > d_min)
+	{
+		if(h < t){
+			t = h;
+		}else{
+			t = deadline_before_ticks(task_set, t);
+			if(t < 0){
+				return 1;
 			}
-			time_stamps[index] += task_set->tasks[index].period;
+		}
+		h = demand_ticks(task_set, t);
+		INSTRUMENT_CHECKPOINT();
+	}
+
+	return h <= d_min;
+}
+
+static int forward_walk_ticks(TaskSet *task_set, ticks_t l)
+{
+	// Tick values stay far below 2^53, so the double heap holds them exactly
+	int n = task_set->num_tasks;
+	double time[n + 1];
+	int task[n + 1];
+	DeadlineHeap heap = {time, task, n};
+	ticks_t h = 0;
+
+	for(int i = 0; i < n; i++)
+	{
+		time[i] = (double) task_set->ticks[i].deadline;
+		task[i] = i;
+	}
+	for(int i = n / 2 - 1; i >= 0; i--)
+	{
+		heap_sift_down(&heap, i);
+	}
+
+	while(heap.size > 0 && heap.time[0] <= l)
+	{
+		TaskTicks *t = &(task_set->ticks[heap.task[0]]);
+		h += t->wcet;
+		INSTRUMENT_CHECKPOINT();
+		if(h > (ticks_t) heap.time[0]){
+			return 0;
+		}
+
+		heap.time[0] += (double) t->period;
+		heap_sift_down(&heap, 0);
+	}
+
+	return 1;
+}
+
+static analysis_results edf_demand_analysis_ticks(TaskSet *task_set, int (*check)(TaskSet *, ticks_t))
+{
+	analysis_results results = {0, 0.0, TIER_UTILIZATION};
+
+	// Reported from the doubles so the output matches the double analysis
+	for(int i = 0; i < task_set->num_tasks; i++)
+	{
+		Task *t = &(task_set->tasks[i]);
+		results.utilization += t->wcet / t->period;
+	}
+
+	int utilization_cmp = ticks_compare_utilization(task_set);
+	if(utilization_cmp > 0){
+		return results;
+	}
+
+	results.tier = TIER_BOUND;
+	if(ticks_compare_density(task_set) > 0){
+		results.tier = TIER_EXACT;
+		ticks_t l = busy_period_ticks(task_set, utilization_cmp);
+		INSTRUMENT_BUSY_PERIOD((double) l / TICKS_PER_UNIT);
+		if(!check(task_set, l)){
+			return results;
 		}
 	}
 
-	// fputs("Schedulable\n", stderr);
 	results.is_schedulable = 1;
 	return results;
 }
+
+analysis_results edf_analysis_ticks (TaskSet *task_set)
+{
+	return edf_demand_analysis_ticks(task_set, qpa_ticks);
+}
+
+analysis_results edf_forward_analysis_ticks (TaskSet *task_set)
+{
+	return edf_demand_analysis_ticks(task_set, forward_walk_ticks);
+}
@@ -1,6 +1,17 @@
 #ifndef EDF_H
 #define EDF_H
 
+// Processor demand analysis using Quick Processor-demand Analysis (QPA)
 analysis_results edf_analysis (TaskSet *task_set);
 
+// Same verdict, checking every deadline in the busy period in order
+analysis_results edf_forward_analysis (TaskSet *task_set);
+
+// QPA alone, for callers that already know the utilization is at most 1
+int edf_demand_schedulable (TaskSet *task_set, double utilization);
+
+// Exact versions of both over task_set->ticks
+analysis_results edf_analysis_ticks (TaskSet *task_set);
+analysis_results edf_forward_analysis_ticks (TaskSet *task_set);
+
 #endif
@@ -0,0 +1,150 @@
+#include <math.h>
+#include <stddef.h>
+
+#include "fused.h"
+#include "../edf/edf.h"
+#include "../rta/rta.h"
+#include "../rta/blocking.h"
+
+static void fill(PrioritySet *set, TaskSet *task_set, const unsigned int *index, double *blocking) {
+
+    for (unsigned int k = 0; k < set->num_tasks; k++) {
+        Task *task = &task_set->tasks[index[k]];
+        set->wcet[k] = task->wcet;
+        set->period[k] = task->period;
+        set->deadline[k] = task->deadline;
+        set->inv_period[k] = 1.0 / task->period;
+        set->input[k] = index[k];
+    }
+
+    if (blocking != NULL) {
+        set->blocking = blocking;
+        blocking_terms(task_set, index, blocking);
+    }
+}
+
+/*
+ * Exact test of set, with response[0..first) already known to be within
+ * their deadlines. Returns the number of tasks found within theirs, n if
+ * all are.
+ */
+static unsigned int schedulable_prefix(PrioritySet *set, unsigned int first, double *response) {
+
+    for (unsigned int k = first; k < set->num_tasks; k++) {
+        response[k] = 0.0;
+    }
+
+    if (rta_schedulable_from(set, first, response)) {
+        return set->num_tasks;
+    }
+
+    // Everything before the task that missed was overwritten in passing
+    unsigned int k = first;
+    while (response[k] <= set->deadline[k]) {
+        k++;
+    }
+
+    return k;
+}
+
+void fused_analysis(TaskSet *task_set, analysis_results *results) {
+
+    unsigned int n = task_set->num_tasks;
+    double period[n + 1], deadline[n + 1];
+    unsigned int by_period[n + 1], by_deadline[n + 1], scratch[n + 1];
+    double utilization = 0.0, density = 0.0;
+
+    // The one pass over the tasks, summed in input order as the analyses do
+    for (unsigned int i = 0; i < n; i++) {
+        Task *task = &task_set->tasks[i];
+        utilization += task->wcet / task->period;
+        if (task->wcet > 0) {
+            density += task->wcet / fmin(task->period, task->deadline);
+        }
+        period[i] = task->period;
+        deadline[i] = task->deadline;
+        by_period[i] = i;
+        by_deadline[i] = i;
+    }
+
+    for (unsigned int r = 0; r < NUM_FUSED_RESULTS; r++) {
+        results[r] = (analysis_results) {0, utilization, TIER_UTILIZATION};
+    }
+
+    // Processor is overloaded, no scheduler can work
+    if (utilization > 1.0) {
+        return;
+    }
+
+    results[FUSED_EDF].tier = density > 1.0 ? TIER_EXACT : TIER_BOUND;
+    results[FUSED_EDF].is_schedulable = density <= 1.0 || edf_demand_schedulable(task_set, utilization);
+
+    sort_indices(by_period, scratch, period, n);
+    sort_indices(by_deadline, scratch, deadline, n);
+
+    // Highest priority tasks both orders share
+    unsigned int shared = 0;
+    while (shared < n && by_period[shared] == by_deadline[shared]) {
+        shared++;
+    }
+
+    // Blocking terms of the shared tasks can come out summed in another
+    // order, so with any only identical orders are shared
+    int blocked = blocking_applies(task_set);
+    if (blocked && shared < n) {
+        shared = 0;
+    }
+
+    PRIORITY_SET_ON_STACK(rm, n);
+    double blocking[n + 1], response[n + 1];
+    fill(&rm, task_set, by_period, blocked ? blocking : NULL);
+
+    // RM tasks found within their deadlines, each with its response time
+    unsigned int checked = 0;
+
+    // Forced points tests leave no response times to share, so each order
+    // gets its own
+    int points = rta_method_forced() == METHOD_POINTS;
+
+    results[FUSED_RM].tier = TIER_BOUND;
+    results[FUSED_RM].is_schedulable = rta_bound_schedulable(&rm);
+    if (!results[FUSED_RM].is_schedulable && points) {
+        results[FUSED_RM].tier = TIER_EXACT;
+        results[FUSED_RM].is_schedulable = rta_exact_schedulable(&rm, &results[FUSED_RM].method);
+    } else if (!results[FUSED_RM].is_schedulable) {
+        results[FUSED_RM].tier = TIER_EXACT;
+        results[FUSED_RM].method = METHOD_RTA;
+        checked = schedulable_prefix(&rm, 0, response);
+        results[FUSED_RM].is_schedulable = checked == n;
+    }
+
+    if (shared == n) {
+        results[FUSED_DM] = results[FUSED_RM];
+        return;
+    }
+
+    PRIORITY_SET_ON_STACK(dm, n);
+    fill(&dm, task_set, by_deadline, blocked ? blocking : NULL);
+
+    results[FUSED_DM].tier = TIER_BOUND;
+    results[FUSED_DM].is_schedulable = rta_bound_schedulable(&dm);
+    if (results[FUSED_DM].is_schedulable) {
+        return;
+    }
+
+    results[FUSED_DM].tier = TIER_EXACT;
+    if (points) {
+        results[FUSED_DM].is_schedulable = rta_exact_schedulable(&dm, &results[FUSED_DM].method);
+        return;
+    }
+
+    results[FUSED_DM].method = METHOD_RTA;
+
+    // A shared task that missed under RM misses under DM too
+    if (results[FUSED_RM].tier == TIER_EXACT && checked < shared) {
+        return;
+    }
+
+    unsigned int first = checked < shared ? checked : shared;
+    results[FUSED_DM].is_schedulable = schedulable_prefix(&dm, first, response) == n;
+}
@@ -0,0 +1,34 @@
+#ifndef FUSED_H
+#define FUSED_H
+
+#include "../task_types.h"
+
+/*
+ * EDF, RM and DM analysis of one task set in a single pass, with the same
+ * verdicts, utilizations and tiers as edf_analysis, rm_analysis and
+ * dm_analysis run one after the other.
+ *
+ * The tasks are read once for the utilization, the density and both sort
+ * keys, and the period and deadline orders are sorted from those. Where the
+ * two orders agree on their highest priority tasks, those tasks' response
+ * times are the same under RM and DM, so DM takes them over from RM's
+ * analysis and only computes the rest. When the orders agree completely DM
+ * gets RM's verdict as is.
+ *
+ * The exact tests are response-time iterations, except when rta_method_use
+ * forces the scheduling points test, which RM and DM then run on their own.
+ */
+
+typedef enum FusedResult {
+
+    FUSED_EDF,
+    FUSED_RM,
+    FUSED_DM,
+    NUM_FUSED_RESULTS
+
+} FusedResult;
+
+// Fills results[FUSED_EDF], results[FUSED_RM] and results[FUSED_DM]
+void fused_analysis(TaskSet *task_set, analysis_results *results);
+
+#endif //FUSED_H
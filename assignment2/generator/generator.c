@@ -0,0 +1,119 @@
+#include <math.h>
+#include <string.h>
+
+#include "generator.h"
+
+// Periods of 0 ticks are bumped to this, like the Ada generator's 0.1
+#define MIN_PERIOD (TICKS_PER_UNIT / 10)
+
+static uint64_t splitmix64(uint64_t *x) {
+
+    uint64_t z = (*x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+
+    return (x << k) | (x >> (64 - k));
+
+}
+
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream) {
+
+    // Mix the stream in first so neighbouring streams start far apart
+    uint64_t x = seed;
+    uint64_t mixed = splitmix64(&x) ^ stream;
+    x = splitmix64(&mixed);
+
+    for (unsigned int i = 0; i < 4; i++) {
+        rng->state[i] = splitmix64(&x);
+    }
+}
+
+double rng_uniform(Rng *rng) {
+
+    uint64_t *s = rng->state;
+    uint64_t result = rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return (double) (result >> 11) * 0x1p-53;
+}
+
+double generator_utilization(const GeneratorConfig *config, unsigned int index) {
+
+    unsigned int level = (unsigned int) ((uint64_t) index * GENERATOR_UTILIZATION_LEVELS
+                                         / config->num_task_sets);
+    return 0.05 + 0.1 * level;
+
+}
+
+/*
+ * Periods are uniform on [0, 10), [0, 100) or [0, 1000) with equal odds.
+ * The Ada generator means to do the same but its range test only ever
+ * picks the first or the last range.
+ */
+static ticks_t draw_period(Rng *rng) {
+
+    double choice = rng_uniform(rng);
+    double range = choice < 1.0 / 3 ? 10.0 : choice < 2.0 / 3 ? 100.0 : 1000.0;
+
+    ticks_t period = (ticks_t) (range * TICKS_PER_UNIT * rng_uniform(rng));
+    return period > 0 ? period : MIN_PERIOD;
+}
+
+static ticks_t draw_deadline(Rng *rng, ticks_t wcet, ticks_t period, DeadlineRange deadlines) {
+
+    ticks_t lowest = deadlines == DEADLINES_TIGHT ? wcet + (period - wcet + 1) / 2 : wcet;
+    return lowest + (ticks_t) ((period - lowest) * rng_uniform(rng));
+
+}
+
+void generate_task_set(const GeneratorConfig *config, unsigned int index, Rng *rng, Task *tasks) {
+
+    unsigned int n = config->num_tasks;
+    double remaining = generator_utilization(config, index);
+
+    rng_seed(rng, config->seed, index);
+
+    for (unsigned int i = 0; i < n; i++) {
+
+        // UUniFast, each task takes a share of what the later ones leave
+        double utilization = remaining;
+        if (i + 1 < n) {
+            double next = remaining * pow(rng_uniform(rng), 1.0 / (n - 1 - i));
+            utilization = remaining - next;
+            remaining = next;
+        }
+
+        ticks_t period = draw_period(rng);
+        ticks_t wcet = (ticks_t) (period * utilization);
+        ticks_t deadline = draw_deadline(rng, wcet, period, config->deadlines);
+
+        // Same doubles the text parsers produce for "x.yz"
+        tasks[i].wcet = (double) wcet / TICKS_PER_UNIT;
+        tasks[i].deadline = (double) deadline / TICKS_PER_UNIT;
+        tasks[i].period = (double) period / TICKS_PER_UNIT;
+    }
+}
+
+int generator_parse_deadlines(const char *name, DeadlineRange *deadlines) {
+
+    if (strcmp(name, "wide") == 0) {
+        *deadlines = DEADLINES_WIDE;
+    } else if (strcmp(name, "tight") == 0) {
+        *deadlines = DEADLINES_TIGHT;
+    } else {
+        return -1;
+    }
+
+    return 0;
+}
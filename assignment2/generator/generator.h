@@ -0,0 +1,66 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stdint.h>
+
+#include "../task_types.h"
+
+/*
+ * C port of taskgenerator/task_generator.adb, for generating task sets in
+ * process instead of writing and re-parsing text files.
+ *
+ * Like the Ada generator, the sets are split evenly over the total
+ * utilizations 0.05, 0.15, ..., 0.95 in that order, individual utilizations
+ * come from UUniFast and deadlines are drawn from [C, P] (wide) or the upper
+ * half of it (tight). All parameters are whole ticks, as in the files.
+ *
+ * Every set is generated from its own random stream, derived from the seed
+ * and the set's index, so a set comes out the same whichever thread makes
+ * it and in whatever order.
+ */
+
+#define GENERATOR_UTILIZATION_LEVELS 10
+
+typedef enum DeadlineRange {
+
+    DEADLINES_WIDE,     // C <= D <= P
+    DEADLINES_TIGHT,    // C + (P - C) / 2 <= D <= P
+
+} DeadlineRange;
+
+typedef struct GeneratorConfig {
+
+    unsigned int num_task_sets;
+    unsigned int num_tasks;
+    DeadlineRange deadlines;
+    uint64_t seed;
+
+} GeneratorConfig;
+
+// xoshiro256** state, one per thread
+typedef struct Rng {
+
+    uint64_t state[4];
+
+} Rng;
+
+// Starts rng on the stream for (seed, stream)
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream);
+
+// Uniform on [0, 1)
+double rng_uniform(Rng *rng);
+
+// Total utilization the index'th set is generated for
+double generator_utilization(const GeneratorConfig *config, unsigned int index);
+
+/*
+ * Generates the index'th task set of config into tasks, which must hold
+ * config->num_tasks tasks. rng is only used as scratch, it is reseeded for
+ * the set.
+ */
+void generate_task_set(const GeneratorConfig *config, unsigned int index, Rng *rng, Task *tasks);
+
+// Parses "wide" or "tight", returns -1 otherwise
+int generator_parse_deadlines(const char *name, DeadlineRange *deadlines);
+
+#endif //GENERATOR_H
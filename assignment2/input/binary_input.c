@@ -0,0 +1,141 @@
+#include <errno.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_input.h"
+
+// Tasks are stored exactly as the struct lays them out
+_Static_assert(sizeof(Task) == 3 * sizeof(double), "Task must be three packed doubles");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#define NATIVE_LITTLE_ENDIAN 0
+#else
+#define NATIVE_LITTLE_ENDIAN 1
+#endif
+
+static int fail(ParseError *error, uint64_t offset, const char *message) {
+
+    error->offset = (size_t) offset;
+    error->message = message;
+    return -1;
+
+}
+
+// True if count items of size bytes starting at offset fit in a file of size bytes
+static int fits(uint64_t offset, uint64_t count, uint64_t size, uint64_t file_size) {
+
+    return offset <= file_size && count <= (file_size - offset) / size;
+
+}
+
+int isBinaryInput(const MappedInput *input) {
+
+    return input->size >= sizeof(BinaryHeader)
+           && memcmp(input->data, BINARY_MAGIC, sizeof(((BinaryHeader *) 0)->magic)) == 0;
+
+}
+
+int parseBinary(const MappedInput *input, ProgramInfo *program, ParseError *error) {
+
+    if (!isBinaryInput(input)) {
+        return fail(error, 0, "not a binary task set file");
+    }
+
+    if (!NATIVE_LITTLE_ENDIAN) {
+        return fail(error, 0, "binary task set files need a little-endian host");
+    }
+
+    BinaryHeader header;
+    memcpy(&header, input->data, sizeof(header));
+
+    if (header.version != BINARY_VERSION) {
+        return fail(error, offsetof(BinaryHeader, version), "unsupported binary format version");
+    }
+
+    if (header.header_size < sizeof(BinaryHeader) || header.num_task_sets > UINT_MAX
+        || header.offsets_offset % sizeof(uint64_t) != 0 || header.tasks_offset % sizeof(double) != 0
+        || !fits(header.offsets_offset, header.num_task_sets + 1, sizeof(uint64_t), input->size)
+        || !fits(header.tasks_offset, header.num_tasks, sizeof(Task), input->size)) {
+        return fail(error, 0, "corrupt header");
+    }
+
+    const uint64_t *offsets = (const uint64_t *) (input->data + header.offsets_offset);
+    Task *tasks = (Task *) (input->data + header.tasks_offset);
+
+    if (offsets[0] != 0 || offsets[header.num_task_sets] != header.num_tasks) {
+        return fail(error, header.offsets_offset, "task set offsets don't cover the tasks");
+    }
+
+    program->num_task_sets = (unsigned int) header.num_task_sets;
+    program->task_sets = malloc(header.num_task_sets * sizeof(TaskSet));
+
+    for (uint64_t i = 0; i < header.num_task_sets; i++) {
+
+        if (offsets[i + 1] < offsets[i] || offsets[i + 1] - offsets[i] > UINT_MAX) {
+            free(program->task_sets);
+            return fail(error, header.offsets_offset + i * sizeof(uint64_t), "bad task set offset");
+        }
+
+        // The mapping is read-only, none of the analyses write to tasks
+        TaskSet *task_set = &program->task_sets[i];
+        task_set->num_tasks = (unsigned int) (offsets[i + 1] - offsets[i]);
+        task_set->tasks = tasks + offsets[i];
+        task_set->ticks = NULL;
+        task_set->num_sections = 0;
+        task_set->sections = NULL;
+    }
+
+    return 0;
+}
+
+int writeBinary(const ProgramInfo *program, FILE *file) {
+
+    if (!NATIVE_LITTLE_ENDIAN) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    // The format has no place for critical sections
+    for (unsigned int i = 0; i < program->num_task_sets; i++) {
+        if (program->task_sets[i].num_sections > 0) {
+            errno = ENOTSUP;
+            return -1;
+        }
+    }
+
+    BinaryHeader header = {BINARY_MAGIC};
+    header.version = BINARY_VERSION;
+    header.header_size = sizeof(BinaryHeader);
+    header.num_task_sets = program->num_task_sets;
+    header.offsets_offset = sizeof(BinaryHeader);
+    header.tasks_offset = header.offsets_offset + (header.num_task_sets + 1) * sizeof(uint64_t);
+
+    for (unsigned int i = 0; i < program->num_task_sets; i++) {
+        header.num_tasks += program->task_sets[i].num_tasks;
+    }
+
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        return -1;
+    }
+
+    uint64_t offset = 0;
+    for (unsigned int i = 0; i <= program->num_task_sets; i++) {
+        if (fwrite(&offset, sizeof(offset), 1, file) != 1) {
+            return -1;
+        }
+        if (i < program->num_task_sets) {
+            offset += program->task_sets[i].num_tasks;
+        }
+    }
+
+    for (unsigned int i = 0; i < program->num_task_sets; i++) {
+        TaskSet *task_set = &program->task_sets[i];
+        if (fwrite(task_set->tasks, sizeof(Task), task_set->num_tasks, file) != task_set->num_tasks) {
+            return -1;
+        }
+    }
+
+    return fflush(file) == 0 ? 0 : -1;
+}
@@ -0,0 +1,53 @@
+#ifndef BINARY_INPUT_H
+#define BINARY_INPUT_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "../task_types.h"
+#include "mapped_input.h"
+
+/*
+ * Binary task set file, version 1. All fields are little-endian.
+ *
+ *     BinaryHeader
+ *     uint64_t offsets[num_task_sets + 1]    index of each set's first task
+ *     Task     tasks[num_tasks]              wcet, deadline, period doubles
+ *
+ * Set i holds tasks[offsets[i]] up to tasks[offsets[i + 1]]. Both arrays are
+ * 8-byte aligned, so a mapped file is used in place without copying tasks.
+ */
+
+#define BINARY_MAGIC "TASKSETS"
+#define BINARY_VERSION 1
+
+typedef struct BinaryHeader {
+
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+
+    uint64_t num_task_sets;
+    uint64_t num_tasks;
+
+    // Byte offsets from the start of the file
+    uint64_t offsets_offset;
+    uint64_t tasks_offset;
+
+} BinaryHeader;
+
+// True if the mapped file starts with the binary magic
+int isBinaryInput(const MappedInput *input);
+
+/*
+ * Points program at the task sets in a mapped binary file. The task arrays
+ * live in the mapping, which has to stay mapped while program is in use.
+ * Returns 0 on success, or -1 with the problem described in error.
+ */
+int parseBinary(const MappedInput *input, ProgramInfo *program, ParseError *error);
+
+// Writes program in the binary format. Returns 0, or -1 with errno set, which
+// is ENOTSUP for sets with critical sections as the format has no room for them
+int writeBinary(const ProgramInfo *program, FILE *file);
+
+#endif //BINARY_INPUT_H
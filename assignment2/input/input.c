@@ -0,0 +1,240 @@
+// getline
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "input.h"
+
+FILE *openInput(char *filename) {
+
+    return filename == NULL ? stdin : fopen(filename, "r");
+
+}
+
+void readTaskSetCount(FILE *file, unsigned int *num_task_sets) {
+
+    char line[256];  // Should be long enough
+
+    // First line designating number of task sets
+    if(!fgets(line, sizeof(line), file)) exit(-1);
+    *num_task_sets = (unsigned int) strtoul(line, NULL, 10);
+
+}
+
+// Task lines longer than this, with many critical sections, are read in two goes
+#define LINE_SIZE 256
+
+// Carves size bytes off arena, giving up like a failed read when memory runs out
+static void *allocate(Arena *arena, size_t size) {
+
+    void *memory = arena_alloc(arena, size);
+    if(!memory) exit(-1);
+    return memory;
+}
+
+// Adds a critical section, moving the array to one twice the size whenever it's full
+static void appendSection(TaskSet *task_set, Arena *arena, unsigned int *capacity, unsigned int task,
+                          unsigned int resource, double length) {
+
+    unsigned int n = task_set->num_sections;
+
+    if (n == *capacity) {
+        *capacity = n ? 2 * n : 4;
+        CriticalSection *sections = allocate(arena, *capacity * sizeof(CriticalSection));
+        if (n > 0) {
+            memcpy(sections, task_set->sections, n * sizeof(CriticalSection));
+        }
+        task_set->sections = sections;
+    }
+
+    task_set->sections[n] = (CriticalSection) {task, resource, length};
+    task_set->num_sections = n + 1;
+}
+
+/*
+ * Reads a line into line, LINE_SIZE bytes, and returns it. A line that
+ * doesn't fit is finished with getline and returned from *long_line
+ * instead, which the caller frees, so short lines never allocate.
+ */
+static char *readLine(FILE *file, char *line, char **long_line) {
+
+    if(!fgets(line, LINE_SIZE, file)) exit(-1);
+
+    size_t length = strlen(line);
+    if (length < LINE_SIZE - 1 || line[length - 1] == '\n') {
+        return line;
+    }
+
+    char *rest = NULL;
+    size_t rest_size = 0;
+    ssize_t rest_length = getline(&rest, &rest_size, file);
+
+    // The line filled the buffer exactly and the file ends right after it
+    if (rest_length < 0) {
+        free(rest);
+        return line;
+    }
+
+    *long_line = realloc(*long_line, length + rest_length + 1);
+    memcpy(*long_line, line, length);
+    memcpy(*long_line + length, rest, rest_length + 1);
+    free(rest);
+
+    return *long_line;
+}
+
+static unsigned int readTaskCount(FILE *file) {
+
+    char line[LINE_SIZE];
+
+    // Get line declaring task set
+    if(!fgets(line, sizeof(line), file)) exit(-1);
+    return (unsigned int) strtol(line, NULL, 10);
+
+}
+
+// Parses task_set->num_tasks task lines into task_set->tasks, the sections into arena
+static void readTasks(FILE *file, TaskSet *task_set, Arena *arena) {
+
+    char line[LINE_SIZE];
+    char *long_line = NULL;
+    unsigned int section_capacity = 0;
+
+    task_set->sections = NULL;
+    task_set->num_sections = 0;
+
+    // Task declaration
+    for (unsigned int j = 0; j < task_set->num_tasks; j++) {
+
+        // Get line declaring task
+        char *task_line = readLine(file, line, &long_line);
+
+        Task *task = &task_set->tasks[j];
+
+        char *state;
+
+        // WCET
+        task->wcet = strtod(task_line, &state);
+
+        // Deadline
+        task->deadline = strtod(state, &state);
+
+        // Period
+        task->period = strtod(state, &state);
+
+        // Critical sections, resource:length
+        for (;;) {
+            char *end;
+            unsigned long resource = strtoul(state, &end, 10);
+            if (end == state || *end != ':') {
+                break;
+            }
+            double length = strtod(end + 1, &state);
+            appendSection(task_set, arena, &section_capacity, j, (unsigned int) resource, length);
+        }
+    }
+
+    free(long_line);
+}
+
+void readTaskSet(FILE *file, TaskSet *task_set, Arena *arena) {
+
+    // Set up task set
+    task_set->num_tasks = readTaskCount(file);
+    task_set->tasks = allocate(arena, task_set->num_tasks * sizeof(Task));
+    task_set->ticks = NULL;
+
+    readTasks(file, task_set, arena);
+}
+
+ProgramInfo parseFile(char *filename, Arena *arena) {
+
+    ProgramInfo program;
+    FILE *file = openInput(filename);
+
+    readTaskSetCount(file, &program.num_task_sets);
+    program.task_sets = allocate(arena, program.num_task_sets * sizeof(TaskSet));
+
+    // Task set declaration
+    for (unsigned int i = 0; i < program.num_task_sets; i++) {
+        readTaskSet(file, &program.task_sets[i], arena);
+    }
+
+    if (file != stdin) {
+        fclose(file);
+    }
+
+    return program;
+}
+
+// Prints value with the fewest decimals that strtod turns back into value
+static int writeValue(double value, char separator, FILE *file) {
+
+    char text[64];
+
+    // Generator values have at most two decimals, print those without the search
+    double hundredths = round(value * 100);
+    if (hundredths / 100 == value && fabs(hundredths) < 1e15) {
+        long long whole = llabs((long long) hundredths);
+        const char *sign = value < 0 ? "-" : "";
+        int result = whole % 10 != 0 ? fprintf(file, "%s%lld.%02lld%c", sign, whole / 100, whole % 100, separator)
+                   : whole % 100 != 0 ? fprintf(file, "%s%lld.%lld%c", sign, whole / 100, whole % 100 / 10, separator)
+                   : fprintf(file, "%s%lld%c", sign, whole / 100, separator);
+        return result < 0 ? -1 : 0;
+    }
+
+    for (int decimals = 0; decimals <= 17; decimals++) {
+        snprintf(text, sizeof(text), "%.*f", decimals, value);
+        if (strtod(text, NULL) == value) {
+            return fprintf(file, "%s%c", text, separator) < 0 ? -1 : 0;
+        }
+    }
+
+    return fprintf(file, "%.17g%c", value, separator) < 0 ? -1 : 0;
+}
+
+int writeTaskSets(const ProgramInfo *program, FILE *file) {
+
+    if (fprintf(file, "%u\n", program->num_task_sets) < 0) {
+        return -1;
+    }
+
+    for (unsigned int i = 0; i < program->num_task_sets; i++) {
+
+        TaskSet *task_set = &program->task_sets[i];
+
+        if (fprintf(file, "%u\n", task_set->num_tasks) < 0) {
+            return -1;
+        }
+
+        unsigned int k = 0;
+
+        for (unsigned int j = 0; j < task_set->num_tasks; j++) {
+
+            unsigned int end = k;
+            while (end < task_set->num_sections && task_set->sections[end].task == j) {
+                end++;
+            }
+
+            Task *task = &task_set->tasks[j];
+            if (writeValue(task->wcet, ' ', file) != 0
+                || writeValue(task->deadline, ' ', file) != 0
+                || writeValue(task->period, end > k ? ' ' : '\n', file) != 0) {
+                return -1;
+            }
+
+            for (; k < end; k++) {
+                CriticalSection *section = &task_set->sections[k];
+                if (fprintf(file, "%u:", section->resource) < 0
+                    || writeValue(section->length, k + 1 < end ? ' ' : '\n', file) != 0) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return fflush(file) == 0 ? 0 : -1;
+}
@@ -0,0 +1,50 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdio.h>
+
+#include "../task_types.h"
+#include "../arena/arena.h"
+
+/*
+ * Line based reader for the task generator's text format
+ *
+ *     num_task_sets
+ *     num_tasks
+ *     wcet deadline period [resource:length ...]
+ *     ...
+ *
+ * where each resource:length pair is the task's longest critical section on
+ * that resource, resources being numbered freely.
+ */
+
+// Opens filename for reading, or returns stdin when filename is NULL
+FILE *openInput(char *filename);
+
+// Reads the first line of the file, the number of task sets that follow
+void readTaskSetCount(FILE *file, unsigned int *num_task_sets);
+
+/*
+ * Reads the next task set into task_set, its tasks and critical sections
+ * carved from arena. The sections array is moved to one twice the size as
+ * it fills, so it may leave as much again unused behind it. A caller
+ * reading set after set resets the arena in between, which keeps its
+ * footprint flat and stops it allocating once the largest sets have been
+ * seen.
+ */
+void readTaskSet(FILE *file, TaskSet *task_set, Arena *arena);
+
+/*
+ * Reads a whole file into memory at once. The task sets, tasks and critical
+ * sections all come from arena, so the program is released in one go.
+ * Running out of memory ends the program like a failed read.
+ */
+ProgramInfo parseFile(char *filename, Arena *arena);
+
+/*
+ * Writes program back out in the text format, each value with the fewest
+ * decimals that read back as the same double. Returns 0, or -1 on error.
+ */
+int writeTaskSets(const ProgramInfo *program, FILE *file);
+
+#endif //INPUT_H
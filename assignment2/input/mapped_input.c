@@ -0,0 +1,494 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mapped_input.h"
+#include "../parallel/parallel.h"
+
+// Mantissas below this convert to double exactly
+#define EXACT_MANTISSA (1ULL << 53)
+
+static const double powers_of_ten[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+#define MAX_EXACT_SCALE (sizeof(powers_of_ten) / sizeof(powers_of_ten[0]) - 1)
+
+// Cursor over [pos, end) of the mapping
+typedef struct Scanner {
+
+    const char *base;
+    const char *pos;
+    const char *end;
+
+    // Start of the line being scanned, for error offsets
+    const char *line;
+
+} Scanner;
+
+// One chunk of the file, parsed independently of the others
+typedef struct Chunk {
+
+    const char *begin;
+    const char *end;
+
+    TaskSet *task_sets;
+    unsigned int num_task_sets;
+    unsigned int set_capacity;
+
+    Task *tasks;
+    size_t num_tasks;
+    size_t task_capacity;
+
+    CriticalSection *sections;
+    size_t num_sections;
+    size_t section_capacity;
+
+    int failed;
+    ParseError error;
+
+} Chunk;
+
+typedef struct ChunkJob {
+
+    const char *base;
+    Chunk *chunks;
+
+} ChunkJob;
+
+int mapInput(const char *filename, MappedInput *input) {
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    input->size = (size_t) st.st_size;
+    input->data = NULL;
+
+    if (input->size > 0) {
+        // Fault the pages in up front rather than one by one while parsing,
+        // or while analyzing in the case of binary files used in place
+        void *data = mmap(NULL, input->size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return -1;
+        }
+        madvise(data, input->size, MADV_SEQUENTIAL);
+        input->data = data;
+    }
+
+    close(fd);
+    return 0;
+}
+
+void unmapInput(MappedInput *input) {
+
+    if (input->data != NULL) {
+        munmap((void *) input->data, input->size);
+        input->data = NULL;
+    }
+}
+
+static int fail(Scanner *scanner, ParseError *error, const char *message) {
+
+    error->offset = (size_t) (scanner->line - scanner->base);
+    error->message = message;
+    return -1;
+
+}
+
+static inline void skipBlanks(Scanner *scanner) {
+
+    while (scanner->pos < scanner->end && (*scanner->pos == ' ' || *scanner->pos == '\t')) {
+        scanner->pos++;
+    }
+}
+
+static inline int isDigit(char c) {
+
+    return c >= '0' && c <= '9';
+
+}
+
+// Skips trailing blanks and the line terminator. Returns 0 if anything else is left on the line
+static inline int endLine(Scanner *scanner) {
+
+    skipBlanks(scanner);
+
+    if (scanner->pos < scanner->end && *scanner->pos == '\r') {
+        scanner->pos++;
+    }
+
+    if (scanner->pos < scanner->end) {
+        if (*scanner->pos != '\n') {
+            return 0;
+        }
+        scanner->pos++;
+    }
+
+    scanner->line = scanner->pos;
+    return 1;
+}
+
+// Skips lines containing only whitespace
+static inline void skipEmptyLines(Scanner *scanner) {
+
+    for (;;) {
+        const char *pos = scanner->pos;
+        while (pos < scanner->end && (*pos == ' ' || *pos == '\t' || *pos == '\r')) {
+            pos++;
+        }
+        if (pos < scanner->end && *pos == '\n') {
+            scanner->pos = pos + 1;
+            scanner->line = scanner->pos;
+        } else {
+            return;
+        }
+    }
+}
+
+static inline int scanUnsigned(Scanner *scanner, unsigned int *value) {
+
+    skipBlanks(scanner);
+
+    if (scanner->pos >= scanner->end || !isDigit(*scanner->pos)) {
+        return 0;
+    }
+
+    uint64_t n = 0;
+    while (scanner->pos < scanner->end && isDigit(*scanner->pos)) {
+        n = n * 10 + (uint64_t) (*scanner->pos++ - '0');
+        if (n > UINT32_MAX) {
+            return 0;
+        }
+    }
+
+    *value = (unsigned int) n;
+    return 1;
+}
+
+// strtod on a bounded copy, for anything the fast path does not handle
+static int scanSlow(Scanner *scanner, const char *start, double *value) {
+
+    char buffer[64];
+    size_t length = 0;
+
+    while (start + length < scanner->end && length < sizeof(buffer) - 1
+           && strchr("+-.0123456789eEinfatyINFATY", start[length]) != NULL) {
+        length++;
+    }
+
+    memcpy(buffer, start, length);
+    buffer[length] = '\0';
+
+    char *stop;
+    *value = strtod(buffer, &stop);
+    if (stop == buffer) {
+        return 0;
+    }
+
+    scanner->pos = start + (stop - buffer);
+    return 1;
+}
+
+/*
+ * Decimal scanner for the generator's "ddd.dd" fields. The digits are
+ * accumulated as an integer mantissa and divided by an exact power of ten,
+ * which gives the correctly rounded double, the same value strtod returns.
+ * Exponents, signs and overlong mantissas go through strtod instead.
+ */
+static inline int scanDecimal(Scanner *scanner, double *value) {
+
+    skipBlanks(scanner);
+
+    const char *start = scanner->pos;
+    const char *pos = start;
+    uint64_t mantissa = 0;
+    unsigned int digits = 0;
+    unsigned int scale = 0;
+
+    while (pos < scanner->end && isDigit(*pos) && digits < 19) {
+        mantissa = mantissa * 10 + (uint64_t) (*pos++ - '0');
+        digits++;
+    }
+
+    if (pos < scanner->end && *pos == '.') {
+        pos++;
+        while (pos < scanner->end && isDigit(*pos) && digits < 19) {
+            mantissa = mantissa * 10 + (uint64_t) (*pos++ - '0');
+            digits++;
+            scale++;
+        }
+    }
+
+    int plain = digits > 0 && mantissa < EXACT_MANTISSA && scale <= MAX_EXACT_SCALE
+                && (pos >= scanner->end || !(isDigit(*pos) || *pos == 'e' || *pos == 'E' || *pos == '.'));
+
+    if (!plain) {
+        return scanSlow(scanner, start, value);
+    }
+
+    *value = (double) mantissa / powers_of_ten[scale];
+    scanner->pos = pos;
+    return 1;
+}
+
+static Task *allocateTasks(Chunk *chunk, unsigned int count) {
+
+    if (chunk->num_tasks + count > chunk->task_capacity) {
+        size_t capacity = chunk->task_capacity ? chunk->task_capacity * 2 : 1024;
+        while (capacity < chunk->num_tasks + count) {
+            capacity *= 2;
+        }
+        chunk->tasks = realloc(chunk->tasks, capacity * sizeof(Task));
+        chunk->task_capacity = capacity;
+    }
+
+    Task *tasks = &chunk->tasks[chunk->num_tasks];
+    chunk->num_tasks += count;
+    return tasks;
+}
+
+static void appendSection(Chunk *chunk, CriticalSection section) {
+
+    if (chunk->num_sections == chunk->section_capacity) {
+        chunk->section_capacity = chunk->section_capacity ? chunk->section_capacity * 2 : 256;
+        chunk->sections = realloc(chunk->sections, chunk->section_capacity * sizeof(CriticalSection));
+    }
+
+    chunk->sections[chunk->num_sections++] = section;
+}
+
+// Scans the resource:length pairs after a task's period, if any
+static int scanSections(Scanner *scanner, Chunk *chunk, TaskSet *task_set, unsigned int task) {
+
+    skipBlanks(scanner);
+
+    while (scanner->pos < scanner->end && isDigit(*scanner->pos)) {
+
+        CriticalSection section = {task};
+
+        if (!scanUnsigned(scanner, &section.resource) || scanner->pos >= scanner->end
+            || *scanner->pos != ':') {
+            return 0;
+        }
+        scanner->pos++;
+
+        if (!scanDecimal(scanner, &section.length)) {
+            return 0;
+        }
+
+        appendSection(chunk, section);
+        task_set->num_sections++;
+        skipBlanks(scanner);
+    }
+
+    return 1;
+}
+
+static TaskSet *allocateTaskSet(Chunk *chunk) {
+
+    if (chunk->num_task_sets == chunk->set_capacity) {
+        chunk->set_capacity = chunk->set_capacity ? chunk->set_capacity * 2 : 256;
+        chunk->task_sets = realloc(chunk->task_sets, chunk->set_capacity * sizeof(TaskSet));
+    }
+
+    return &chunk->task_sets[chunk->num_task_sets++];
+}
+
+static int parseChunk(const char *base, Chunk *chunk) {
+
+    Scanner scanner = {base, chunk->begin, chunk->end, chunk->begin};
+
+    for (;;) {
+
+        skipEmptyLines(&scanner);
+        if (scanner.pos >= scanner.end) {
+            break;
+        }
+
+        // Line declaring task set
+        unsigned int num_tasks;
+        if (!scanUnsigned(&scanner, &num_tasks) || !endLine(&scanner)) {
+            return fail(&scanner, &chunk->error, "expected task count");
+        }
+
+        // Tasks are addressed by index until the chunk's array stops moving,
+        // and so are critical sections
+        TaskSet *task_set = allocateTaskSet(chunk);
+        task_set->num_tasks = num_tasks;
+        task_set->tasks = (Task *) (uintptr_t) chunk->num_tasks;
+        task_set->ticks = NULL;
+        task_set->num_sections = 0;
+        task_set->sections = (CriticalSection *) (uintptr_t) chunk->num_sections;
+        Task *tasks = allocateTasks(chunk, num_tasks);
+
+        // Task declaration
+        for (unsigned int j = 0; j < num_tasks; j++) {
+
+            skipEmptyLines(&scanner);
+            if (scanner.pos >= scanner.end) {
+                return fail(&scanner, &chunk->error, "task set ends early");
+            }
+
+            Task *task = &tasks[j];
+
+            if (!scanDecimal(&scanner, &task->wcet)
+                || !scanDecimal(&scanner, &task->deadline)
+                || !scanDecimal(&scanner, &task->period)) {
+                return fail(&scanner, &chunk->error, "expected wcet deadline period");
+            }
+
+            if (!scanSections(&scanner, chunk, task_set, j) || !endLine(&scanner)) {
+                return fail(&scanner, &chunk->error, "expected resource:length");
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < chunk->num_task_sets; i++) {
+        TaskSet *task_set = &chunk->task_sets[i];
+        task_set->tasks = chunk->tasks + (uintptr_t) task_set->tasks;
+        task_set->sections = task_set->num_sections > 0
+                             ? chunk->sections + (uintptr_t) task_set->sections : NULL;
+    }
+
+    return 0;
+}
+
+static void parseChunks(size_t begin, size_t end, unsigned worker, void *ctx) {
+
+    ChunkJob *job = ctx;
+
+    for (size_t i = begin; i < end; i++) {
+        job->chunks[i].failed = parseChunk(job->base, &job->chunks[i]) != 0;
+    }
+}
+
+// True if the line at pos holds a single integer, i.e. declares a task set
+static int isTaskSetLine(const char *pos, const char *end) {
+
+    Scanner scanner = {pos, pos, end, pos};
+    unsigned int value;
+
+    return scanUnsigned(&scanner, &value) && endLine(&scanner);
+
+}
+
+// Moves pos forward to the start of the next line declaring a task set
+static const char *nextTaskSetBoundary(const char *pos, const char *end) {
+
+    // Finish the line pos is in the middle of
+    while (pos < end && pos[-1] != '\n') {
+        pos++;
+    }
+
+    while (pos < end && !isTaskSetLine(pos, end)) {
+        const char *newline = memchr(pos, '\n', (size_t) (end - pos));
+        pos = newline ? newline + 1 : end;
+    }
+
+    return pos;
+}
+
+int parseMapped(const MappedInput *input, unsigned num_chunks, ProgramInfo *program,
+                ParseError *error) {
+
+    const char *base = input->data;
+    const char *end = input->data + input->size;
+    Scanner scanner = {base, base, end, base};
+
+    // First line designating number of task sets
+    skipEmptyLines(&scanner);
+    if (!scanUnsigned(&scanner, &program->num_task_sets) || !endLine(&scanner)) {
+        return fail(&scanner, error, "expected number of task sets");
+    }
+
+    const char *body = scanner.pos;
+
+    if (num_chunks == 0) {
+        num_chunks = 1;
+    }
+
+    // Chunks below this size aren't worth a thread
+    size_t min_chunk = 1 << 20;
+    if ((size_t) (end - body) / num_chunks < min_chunk) {
+        num_chunks = (unsigned) ((size_t) (end - body) / min_chunk) + 1;
+    }
+
+    Chunk *chunks = calloc(num_chunks, sizeof(Chunk));
+    const char *begin = body;
+    unsigned used = 0;
+
+    for (unsigned i = 0; i < num_chunks && begin < end; i++) {
+
+        const char *split = i + 1 == num_chunks
+                            ? end
+                            : nextTaskSetBoundary(body + (size_t) (end - body) * (i + 1) / num_chunks, end);
+
+        if (split > begin) {
+            chunks[used].begin = begin;
+            chunks[used].end = split;
+            used++;
+            begin = split;
+        }
+    }
+
+    ChunkJob job = {base, chunks};
+    parallel_for(used, used, 1, parseChunks, &job);
+
+    int status = 0;
+    unsigned int found = 0;
+
+    for (unsigned i = 0; i < used; i++) {
+        if (chunks[i].failed) {
+            *error = chunks[i].error;
+            status = -1;
+            break;
+        }
+        found += chunks[i].num_task_sets;
+    }
+
+    if (status == 0 && found != program->num_task_sets) {
+        error->offset = input->size;
+        error->message = found < program->num_task_sets ? "fewer task sets than declared"
+                                                        : "more task sets than declared";
+        status = -1;
+    }
+
+    if (status == 0) {
+
+        program->task_sets = malloc(found * sizeof(TaskSet));
+        unsigned int next = 0;
+
+        // Task arrays stay owned by the program, only the set lists are merged
+        for (unsigned i = 0; i < used; i++) {
+            memcpy(&program->task_sets[next], chunks[i].task_sets,
+                   chunks[i].num_task_sets * sizeof(TaskSet));
+            next += chunks[i].num_task_sets;
+        }
+    } else {
+        for (unsigned i = 0; i < used; i++) {
+            free(chunks[i].tasks);
+            free(chunks[i].sections);
+        }
+    }
+
+    for (unsigned i = 0; i < used; i++) {
+        free(chunks[i].task_sets);
+    }
+    free(chunks);
+
+    return status;
+}
@@ -0,0 +1,41 @@
+#ifndef MAPPED_INPUT_H
+#define MAPPED_INPUT_H
+
+#include <stddef.h>
+
+#include "../task_types.h"
+
+/*
+ * Reader for the same text format as input.h that works on a memory mapping
+ * of the whole file. Numbers are scanned in place without copying lines out,
+ * and the file can be split at task set boundaries and parsed in parallel.
+ */
+
+typedef struct MappedInput {
+
+    const char *data;
+    size_t size;
+
+} MappedInput;
+
+typedef struct ParseError {
+
+    // Byte offset of the start of the offending line
+    size_t offset;
+    const char *message;
+
+} ParseError;
+
+// Maps filename read-only. Returns 0 on success, -1 with errno set otherwise
+int mapInput(const char *filename, MappedInput *input);
+void unmapInput(MappedInput *input);
+
+/*
+ * Parses a mapped file into program, splitting it into up to num_chunks
+ * pieces parsed on as many threads. Returns 0 on success, or -1 with the
+ * first malformed line described in error.
+ */
+int parseMapped(const MappedInput *input, unsigned num_chunks, ProgramInfo *program,
+                ParseError *error);
+
+#endif //MAPPED_INPUT_H
@@ -0,0 +1,51 @@
+#include <stddef.h>
+
+#include "instrument.h"
+
+#ifdef ANALYSIS_STATS
+
+_Thread_local AnalysisCounters analysis_counters;
+_Thread_local unsigned long analysis_counters_mark;
+
+int instrument_available(void) {
+
+    return 1;
+
+}
+
+void instrument_begin(unsigned int *task_iterations, unsigned int max_tasks) {
+
+    analysis_counters = (AnalysisCounters) {0, task_iterations, task_iterations != NULL ? max_tasks : 0, 0, 0.0, 0};
+    analysis_counters_mark = 0;
+}
+
+void instrument_end(AnalysisCounters *counters) {
+
+    *counters = analysis_counters;
+
+    // Analyses run outside begin and end, e.g. in -S, mustn't write to it
+    analysis_counters.task_iterations = NULL;
+    analysis_counters.max_tasks = 0;
+}
+
+#else
+
+int instrument_available(void) {
+
+    return 0;
+
+}
+
+void instrument_begin(unsigned int *task_iterations, unsigned int max_tasks) {
+
+    (void) task_iterations;
+    (void) max_tasks;
+}
+
+void instrument_end(AnalysisCounters *counters) {
+
+    *counters = (AnalysisCounters) {0, NULL, 0, 0, 0.0, 0};
+
+}
+
+#endif
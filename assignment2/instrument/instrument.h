@@ -0,0 +1,71 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+/*
+ * Opt-in counters of the work one analysis did, to see why some sets take
+ * far longer than others. They only exist in builds with ANALYSIS_STATS
+ * defined ('make STATS=1', or -DANALYSIS_STATS=ON with CMake). Otherwise
+ * every INSTRUMENT_ macro is empty and the analyses compile exactly as
+ * without them.
+ *
+ * The counters are per thread: instrument_begin clears them, the analysis
+ * run next adds to them and instrument_end copies them out.
+ */
+
+typedef struct AnalysisCounters {
+
+    // RM and DM: iterations of the response-time recurrence, or scheduling
+    // points checked, in total and per task in priority order for the first
+    // num_tasks tasks, the ones analyzed before the test stopped
+    unsigned long iterations;
+    unsigned int *task_iterations;
+    unsigned int max_tasks;
+    unsigned int num_tasks;
+
+    // EDF: the busy period the deadlines were checked up to, in time units,
+    // and the deadlines the demand was checked at
+    double busy_period;
+    unsigned long checkpoints;
+
+} AnalysisCounters;
+
+// 1 in builds with ANALYSIS_STATS, where the calls below do anything
+int instrument_available(void);
+
+// task_iterations has room for max_tasks, or is NULL if not wanted
+void instrument_begin(unsigned int *task_iterations, unsigned int max_tasks);
+void instrument_end(AnalysisCounters *counters);
+
+#ifdef ANALYSIS_STATS
+
+extern _Thread_local AnalysisCounters analysis_counters;
+
+// Iterations since the previous task finished
+extern _Thread_local unsigned long analysis_counters_mark;
+
+static inline void instrument_task(unsigned int task) {
+
+    AnalysisCounters *counters = &analysis_counters;
+
+    if (task < counters->max_tasks) {
+        counters->task_iterations[task] = (unsigned int) (counters->iterations - analysis_counters_mark);
+    }
+    counters->num_tasks = task + 1 > counters->num_tasks ? task + 1 : counters->num_tasks;
+    analysis_counters_mark = counters->iterations;
+}
+
+#define INSTRUMENT_ITERATION()      (analysis_counters.iterations++)
+#define INSTRUMENT_TASK(task)       instrument_task(task)
+#define INSTRUMENT_BUSY_PERIOD(l)   (analysis_counters.busy_period = (l))
+#define INSTRUMENT_CHECKPOINT()     (analysis_counters.checkpoints++)
+
+#else
+
+#define INSTRUMENT_ITERATION()      ((void) 0)
+#define INSTRUMENT_TASK(task)       ((void) 0)
+#define INSTRUMENT_BUSY_PERIOD(l)   ((void) 0)
+#define INSTRUMENT_CHECKPOINT()     ((void) 0)
+
+#endif
+
+#endif //INSTRUMENT_H
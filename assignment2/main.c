@@ -1,21 +1,349 @@
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "task_types.h"
 #include "edf/edf.h"
 #include "rm/rm.h"
 #include "dm/dm.h"
+#include "input/input.h"
+#include "input/mapped_input.h"
+#include "input/binary_input.h"
+#include "generator/generator.h"
+#include "bins/bins.h"
+#include "output/npy.h"
+#include "sensitivity/sensitivity.h"
+#include "opa/opa.h"
+#include "partition/partition.h"
+#include "memo/memo.h"
+#include "sim/sim.h"
+#include "fused/fused.h"
+#include "batch/batch.h"
+#include "instrument/instrument.h"
+#include "parallel/parallel.h"
+#include "pipeline/pipeline.h"
+#include "rta/rta.h"
+#include "rta/interference.h"
+#include "rta/blocking.h"
+#include "ticks/ticks.h"
 
 #define RESULTS_FILE_EDF "out/results_edf.txt"
 #define RESULTS_FILE_RM  "out/results_rm.txt"
 #define RESULTS_FILE_DM  "out/results_dm.txt"
+#define SUMMARY_FILE     "out/summary.txt"
+#define SENSITIVITY_FILE "out/sensitivity.txt"
+#define RESULTS_FILE_OPA "out/results_opa.txt"
+#define PARTITION_FILE   "out/partition.txt"
+#define SIMULATION_FILE  "out/simulation.txt"
+
+// Counters of -I, e.g. out/instrumentation.csv
+#define INSTRUMENT_FILE  "out/instrumentation.%s"
+
+// Column files of -N, e.g. out/results_rm_utilization.npy
+#define RESULTS_COLUMN   "out/results_%s_%s.npy"
+
+// Task sets handed to a worker at a time in parallel mode
+#define PARALLEL_GRAIN 64
+
+// Task sets in flight per analysis thread in streaming mode
+#define STREAM_SLOTS_PER_WORKER 64
+
+// Jobs -X simulates of one set under one algorithm before giving up on it
+#define SIMULATION_MAX_JOBS 10000000
+
+typedef struct Algorithm {
+
+    const char *name;
+    const char *results_file;
+    analysis_fn analyze;
+    sensitivity_fn sensitivity;
+    PartitionTest partition;
+    SimPolicy policy;
+
+} Algorithm;
+
+static Algorithm algorithms[] = {
+    {"edf", RESULTS_FILE_EDF, edf_analysis, edf_sensitivity, PARTITION_EDF, SIM_EDF},
+    {"rm" , RESULTS_FILE_RM , rm_analysis , rm_sensitivity , PARTITION_RM , SIM_RM },
+    {"dm" , RESULTS_FILE_DM , dm_analysis , dm_sensitivity , PARTITION_DM , SIM_DM },
+};
+
+#define NUM_ALGORITHMS (sizeof(algorithms) / sizeof(algorithms[0]))
+
+// Set by -F: all three verdicts come from one fused_analysis call, which
+// fills them in the order of algorithms[]
+static int analyze_fused = 0;
+
+// Task placement heuristics of -P, each run with every algorithm above
+typedef struct Heuristic {
+
+    const char *name;
+    PartitionHeuristic heuristic;
+
+} Heuristic;
+
+static Heuristic heuristics[] = {
+    {"ffd", FIRST_FIT_DECREASING},
+    {"bfd", BEST_FIT_DECREASING },
+    {"wfd", WORST_FIT_DECREASING},
+};
+
+#define NUM_HEURISTICS (sizeof(heuristics) / sizeof(heuristics[0]))
+
+// Output formats of -I
+typedef struct InstrumentFormat {
+
+    const char *name;
+    const char *extension;
+
+} InstrumentFormat;
+
+enum {
+    INSTRUMENT_NONE,
+    INSTRUMENT_CSV,
+    INSTRUMENT_JSON,
+    INSTRUMENT_HISTOGRAMS,
+};
+
+static const InstrumentFormat instrument_formats[] = {
+    [INSTRUMENT_CSV]        = {"csv" , "csv" },
+    [INSTRUMENT_JSON]       = {"json", "json"},
+    [INSTRUMENT_HISTOGRAMS] = {"hist", "txt" },
+};
+
+#define NUM_INSTRUMENT_FORMATS (sizeof(instrument_formats) / sizeof(instrument_formats[0]))
+
+// Buckets of the -I histograms: 0, then [2^(b-1), 2^b) for bucket b
+#define HISTOGRAM_BUCKETS 65
+
+// Priority orders -W writes worst-case response times for
+typedef struct ResponseTimes {
+
+    const char *name;
+    PriorityOrder order;
+
+} ResponseTimes;
+
+static const ResponseTimes response_times[] = {
+    {"rm", PRIORITY_BY_PERIOD  },
+    {"dm", PRIORITY_BY_DEADLINE},
+};
+
+#define NUM_RESPONSE_TIMES (sizeof(response_times) / sizeof(response_times[0]))
+
+typedef struct Options {
+
+    char *filename;
+    unsigned num_workers;
+    int verbose;
+    int streaming;
+    int mapped;
+    int ticks;
+    int edf_forward;
+
+    // Convert the input to these files instead of analyzing it
+    char *binary_output;
+    char *text_output;
+
+    // Generate task sets in process instead of reading a file
+    int generate;
+    GeneratorConfig generator;
+
+    // Utilization bin width of the summary table, 0 for none
+    double bin_width;
+
+    // Skip the per-set result files
+    int quiet;
+
+    // Write results as .npy columns, with response times
+    int npy;
+    int wcrt;
+
+    // Also find every set's breakdown factors
+    int sensitivity;
+
+    // Also search for any fixed priority order that works
+    int opa;
+
+    // Cores to partition every set onto, 0 for none
+    unsigned int cores;
+
+    // Reuse results of sets seen before, kept across runs in memo_file
+    int memo;
+    char *memo_file;
+
+    // Also simulate every schedule to check the analyses' verdicts
+    int simulate;
+
+    // Format to write every analysis' counters in, INSTRUMENT_NONE for none
+    unsigned int instrument;
+
+    // Analyze with every algorithm in one pass
+    int fused;
+
+    // Run the cheap tests on BATCH_SETS sets at a time first
+    int batch;
+
+} Options;
+
+// Per-worker time spent in each algorithm, the tier that decided each set
+// and the summary bins, padded to its own cache line
+typedef struct WorkerStats {
+
+    double seconds[NUM_ALGORITHMS];
+    double fused_seconds;
+    double batch_seconds;
+    unsigned long batch_decided[NUM_ALGORITHMS];
+    unsigned long tiers[NUM_ALGORITHMS][NUM_TIERS];
+    unsigned long methods[NUM_ALGORITHMS][NUM_METHODS];
+    UtilizationBins bins[NUM_ALGORITHMS];
+    unsigned long memo_hits;
+    unsigned long memo_misses;
+    char pad[64];
+
+} WorkerStats;
+
+// Per-worker buffers reused from set to set, grown to the largest set seen
+typedef struct WorkerScratch {
+
+    // The memo key's copy of the tasks, sorted
+    Task *sorted;
+    unsigned int capacity;
+
+    // Generated sets, which are analyzed and dropped a batch at a time
+    Task *tasks;
+    TaskTicks *ticks;
+
+    // Layout of a batch for -A
+    BatchScratch batch;
+
+    // The simulator's state for -X, and room to convert a set to ticks for it
+    SimScratch sim;
+    TaskTicks *sim_ticks;
+
+} WorkerScratch;
+
+// What one analysis of one set did, for -I
+typedef struct AnalysisRecord {
+
+    AnalysisCounters counters;
+    unsigned long nanoseconds;
+
+} AnalysisRecord;
+
+// Packed .npy result columns of one algorithm
+typedef struct ResultColumns {
+
+    NpyFile schedulable;
+    NpyFile utilization;
+
+} ResultColumns;
+
+typedef struct AnalysisJob {
+
+    ProgramInfo *program;
+
+    // Sets are generated on the fly when set, program only gives the count
+    const GeneratorConfig *generator;
+    int ticks;
+    int batch;
+
+    analysis_results *results[NUM_ALGORITHMS];
+    WorkerStats *stats;
+    WorkerScratch *scratch;
+    Memo *memo;
+
+    // Response times of every task, set i's starting at task_offsets[i]
+    double *wcrt[NUM_RESPONSE_TIMES];
+    size_t *task_offsets;
+
+    // Breakdown factors, NUM_ALGORITHMS per set
+    double *sensitivity;
+
+    // Optimal priority assignment verdicts, and the order found for each
+    // schedulable set, highest priority first, at task_offsets[i]
+    analysis_results *opa;
+    unsigned int *opa_order;
+
+    // Partitioned verdicts, NUM_ALGORITHMS for each heuristic in turn per set,
+    // and each worker's scratch for the largest set
+    unsigned int cores;
+    unsigned char *partition;
+    PartitionScratch *partition_scratch;
+
+    // Simulated schedules, NUM_ALGORITHMS per set
+    SimResult *simulation;
+
+    // Counters, NUM_ALGORITHMS per set, with the iterations of set i's tasks
+    // for each algorithm in turn from NUM_ALGORITHMS * task_offsets[i]
+    AnalysisRecord *records;
+    unsigned int *task_iterations;
+
+} AnalysisJob;
+
+typedef struct StreamJob {
+
+    FILE *input;
+    unsigned int sets_left;
+    unsigned int sets_read;
+    int ticks;
+    FILE *results[NUM_ALGORITHMS];
+    ResultColumns *columns;
+    WorkerStats *stats;
+    WorkerScratch *scratch;
+    Memo *memo;
+
+} StreamJob;
 
 /*
  *  FORWARD DECLARATIONS
  */
 
-ProgramInfo parseFile(char *filename);
+Options parseOptions(int argc, char *argv[]);
+ProgramInfo loadMapped(Options *options);
+void convertProgram(ProgramInfo *program, Options *options);
+ProgramInfo generateProgram(Options *options);
+void generateRange(size_t begin, size_t end, unsigned worker, void *ctx);
+void convertToTicks(TaskSet *task_set, unsigned int index, TaskTicks *ticks);
 void writeFile(analysis_results results, FILE *file);
+ResultColumns *openColumns(void);
+void appendColumns(ResultColumns *columns, analysis_results *results, size_t count);
+void closeColumns(ResultColumns *columns);
+void writeResponseTimes(AnalysisJob *job, size_t num_tasks);
+void writeSensitivity(AnalysisJob *job);
+void writeOpa(AnalysisJob *job);
+void writePartition(AnalysisJob *job);
+void simulateTaskSet(TaskSet *task_set, WorkerScratch *scratch, SimResult *results);
+void writeSimulation(AnalysisJob *job);
+void writeInstrumentation(AnalysisJob *job, unsigned int format);
+void writeRecordsCsv(AnalysisJob *job, FILE *file);
+void writeRecordsJson(AnalysisJob *job, FILE *file);
+void writeHistograms(AnalysisJob *job, FILE *file);
+void analyzeTaskSet(TaskSet *task_set, analysis_results *results, AnalysisRecord *records, Memo *memo,
+                    const unsigned char *decided, WorkerStats *stats, WorkerScratch *scratch);
+int orderSensitive(TaskSet *task_set, analysis_results *results);
+double totalUtilization(TaskSet *task_set);
+void analyzeRange(size_t begin, size_t end, unsigned worker, void *ctx);
+void analyzeSet(AnalysisJob *job, TaskSet *task_set, size_t i, analysis_results *results,
+                const unsigned char *decided, unsigned worker);
+void runStreaming(Options *options);
+int streamRead(PipelineSlot *slot, void *ctx);
+void streamAnalyze(PipelineSlot *slot, unsigned worker, void *ctx);
+void streamWrite(PipelineSlot *slot, void *ctx);
+WorkerStats *createStats(Options *options);
+unsigned int maxTasks(ProgramInfo *program, Options *options);
+WorkerScratch *createScratch(Options *options, unsigned int max_tasks);
+Task *scratchTasks(WorkerScratch *scratch, unsigned int num_tasks);
+void freeScratch(WorkerScratch *scratch, Options *options);
+void writeSummary(WorkerStats *stats, Options *options);
+Memo *openMemo(Options *options);
+void closeMemo(Memo *memo, Options *options);
+void reportStats(WorkerStats *stats, unsigned num_workers, unsigned num_task_sets,
+                 double wall_seconds);
+double now(void);
 
 /*
  *  Function Bodies
@@ -23,78 +351,1397 @@ void writeFile(analysis_results results, FILE *file);
 
 int main(int argc, char *argv[]) {
 
-    ProgramInfo program = parseFile(argv[1]);
-    FILE *results_edf = fopen(RESULTS_FILE_EDF, "w+");
-    FILE *results_rm  = fopen(RESULTS_FILE_RM , "w+");
-    FILE *results_dm  = fopen(RESULTS_FILE_DM , "w+");
+    Options options = parseOptions(argc, argv);
+
+    if (options.streaming) {
+        runStreaming(&options);
+        return 0;
+    }
+
+    int converting = options.binary_output != NULL || options.text_output != NULL;
+
+    // Parsed text input lives in the arena, released at once at the end
+    Arena arena;
+    arena_init(&arena, ARENA_CHUNK_SIZE);
+
+    // Generated sets are only kept in memory for conversion
+    ProgramInfo program = {0};
+    if (options.generate && converting) {
+        program = generateProgram(&options);
+    } else if (options.generate) {
+        program.num_task_sets = options.generator.num_task_sets;
+    } else {
+        program = options.mapped ? loadMapped(&options) : parseFile(options.filename, &arena);
+    }
+
+    if (converting) {
+        convertProgram(&program, &options);
+        return 0;
+    }
+
+    if (options.ticks && !options.generate) {
+
+        size_t num_tasks = 0;
+        for (unsigned i = 0; i < program.num_task_sets; i++) {
+            num_tasks += program.task_sets[i].num_tasks;
+        }
+
+        TaskTicks *ticks = malloc((num_tasks + 1) * sizeof(TaskTicks));
+        for (unsigned i = 0; i < program.num_task_sets; i++) {
+            convertToTicks(&program.task_sets[i], i, ticks);
+            ticks += program.task_sets[i].num_tasks;
+        }
+    }
+
+    // Sensitivity, OPA and partitioning leave blocking out, so sections are
+    // only taken when -L none says to ignore them
+    for (unsigned i = 0; i < program.num_task_sets && !options.generate
+                         && (options.sensitivity || options.opa || options.cores); i++) {
+        if (blocking_applies(&program.task_sets[i])) {
+            fprintf(stderr, "task set %u: -S, -O and -P don't account for critical sections, "
+                            "'-L none' ignores them\n", i);
+            exit(-1);
+        }
+    }
+
+    AnalysisJob job = {&program};
+    job.generator = options.generate ? &options.generator : NULL;
+    job.ticks = options.ticks;
+    job.batch = options.batch;
+    for (unsigned a = 0; a < NUM_ALGORITHMS && (!options.quiet || options.simulate); a++) {
+        job.results[a] = malloc(program.num_task_sets * sizeof(analysis_results));
+    }
+    job.stats = createStats(&options);
+    job.scratch = createScratch(&options, maxTasks(&program, &options));
+    job.memo = openMemo(&options);
+
+    size_t num_tasks = 0;
+    if (options.wcrt || options.opa || options.instrument) {
+        job.task_offsets = malloc((program.num_task_sets + 1) * sizeof(size_t));
+        for (unsigned i = 0; i < program.num_task_sets; i++) {
+            job.task_offsets[i] = num_tasks;
+            num_tasks += options.generate ? options.generator.num_tasks : program.task_sets[i].num_tasks;
+        }
+        job.task_offsets[program.num_task_sets] = num_tasks;
+
+        for (unsigned k = 0; k < NUM_RESPONSE_TIMES && options.wcrt; k++) {
+            job.wcrt[k] = malloc((num_tasks + 1) * sizeof(double));
+        }
+    }
+
+    if (options.opa) {
+        job.opa = malloc(program.num_task_sets * sizeof(analysis_results));
+        job.opa_order = malloc((num_tasks + 1) * sizeof(unsigned int));
+    }
+
+    if (options.cores > 0) {
+        job.cores = options.cores;
+        job.partition = malloc((size_t) program.num_task_sets * NUM_HEURISTICS * NUM_ALGORITHMS + 1);
+
+        unsigned int max_tasks = maxTasks(&program, &options);
+        job.partition_scratch = malloc(options.num_workers * sizeof(PartitionScratch));
+        for (unsigned w = 0; w < options.num_workers; w++) {
+            if (partition_scratch_init(&job.partition_scratch[w], options.cores, max_tasks) != 0) {
+                fprintf(stderr, "-P: out of memory for %u cores of %u tasks\n", options.cores, max_tasks);
+                exit(-1);
+            }
+        }
+    }
+
+    if (options.instrument) {
+        job.records = malloc(program.num_task_sets * NUM_ALGORITHMS * sizeof(AnalysisRecord));
+        job.task_iterations = malloc((num_tasks * NUM_ALGORITHMS + 1) * sizeof(unsigned int));
+    }
+
+    if (options.simulate) {
+        job.simulation = malloc(program.num_task_sets * NUM_ALGORITHMS * sizeof(SimResult));
+    }
+
+    if (options.sensitivity) {
+        job.sensitivity = malloc((size_t) program.num_task_sets * NUM_ALGORITHMS * sizeof(double));
+    }
+
+    double start = now();
+    parallel_for(options.num_workers, program.num_task_sets, PARALLEL_GRAIN, analyzeRange, &job);
+    double wall_seconds = now() - start;
+
+    // Results are written after the fact so they stay in input order
+    if (options.npy && !options.quiet) {
+        ResultColumns *columns = openColumns();
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            appendColumns(&columns[a], job.results[a], program.num_task_sets);
+        }
+        closeColumns(columns);
+    }
+
+    if (options.wcrt) {
+        writeResponseTimes(&job, num_tasks);
+    }
+
+    if (options.sensitivity) {
+        writeSensitivity(&job);
+    }
+
+    if (options.opa) {
+        writeOpa(&job);
+    }
+
+    if (options.cores > 0) {
+        writePartition(&job);
+        for (unsigned w = 0; w < options.num_workers; w++) {
+            partition_scratch_free(&job.partition_scratch[w]);
+        }
+        free(job.partition_scratch);
+    }
+
+    if (options.simulate) {
+        writeSimulation(&job);
+    }
 
-    for (int i = 0; i < program.num_task_sets; i++) {
+    if (options.instrument) {
+        writeInstrumentation(&job, options.instrument);
+    }
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS && !options.quiet && !options.npy; a++) {
 
-//        fprintf(stderr, "%i\n", i);
+        FILE *file = fopen(algorithms[a].results_file, "w+");
+
+        for (unsigned i = 0; i < program.num_task_sets; i++) {
+            writeFile(job.results[a][i], file);
+        }
 
-        TaskSet task_set = program.task_sets[i];
+        fclose(file);
+    }
 
-        writeFile(edf_analysis(&task_set), results_edf);
-        writeFile( rm_analysis(&task_set), results_rm );
-        writeFile( dm_analysis(&task_set), results_dm );
+    if (options.bin_width > 0) {
+        writeSummary(job.stats, &options);
+    }
 
+    if (options.verbose) {
+        reportStats(job.stats, options.num_workers, program.num_task_sets, wall_seconds);
     }
 
+    closeMemo(job.memo, &options);
+    freeScratch(job.scratch, &options);
+    arena_free(&arena);
 }
 
-ProgramInfo parseFile(char *filename) {
+Options parseOptions(int argc, char *argv[]) {
 
-    // TODO: Too long. segment into multiple functions
+    Options options = {NULL, 1, 0, 0, 0, 0, 0, NULL, NULL, 0, {0, 10, DEADLINES_WIDE, 1}, 0.0, 0, 0, 0, 0, 0, 0, 0, NULL, 0, INSTRUMENT_NONE, 0, 0};
+    int opt;
 
-    ProgramInfo program;
-    FILE *file = (filename == NULL ? stdin : fopen(filename, "r"));
+    InterferenceKernel kernel;
+    LockingProtocol protocol;
+    analysis_method method;
+
+    while ((opt = getopt(argc, argv, "j:smK:M:E:L:viB:T:G:n:D:R:b:qNWSOP:cC:XI:FA")) != -1) {
+        switch (opt) {
+            case 'j':
+                // -j 0 uses every online core
+                options.num_workers = (unsigned) strtoul(optarg, NULL, 10);
+                if (options.num_workers == 0) {
+                    options.num_workers = parallel_num_cpus();
+                }
+                break;
+            case 'v':
+                options.verbose = 1;
+                break;
+            case 'i':
+                options.ticks = 1;
+                break;
+            case 'B':
+                options.binary_output = optarg;
+                break;
+            case 'T':
+                options.text_output = optarg;
+                break;
+            case 'G':
+                options.generate = 1;
+                options.generator.num_task_sets = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                options.generator.num_tasks = (unsigned) strtoul(optarg, NULL, 10);
+                break;
+            case 'D':
+                if (generator_parse_deadlines(optarg, &options.generator.deadlines) != 0) {
+                    fprintf(stderr, "%s: unknown deadline range '%s'\n", argv[0], optarg);
+                    exit(-1);
+                }
+                break;
+            case 'R':
+                options.generator.seed = strtoull(optarg, NULL, 10);
+                break;
+            case 'b':
+                options.bin_width = strtod(optarg, NULL);
+                if (!(options.bin_width > 0)) {
+                    fprintf(stderr, "%s: bin width must be positive\n", argv[0]);
+                    exit(-1);
+                }
+                break;
+            case 'q':
+                options.quiet = 1;
+                break;
+            case 'N':
+                options.npy = 1;
+                break;
+            case 'W':
+                options.npy = 1;
+                options.wcrt = 1;
+                break;
+            case 'S':
+                options.sensitivity = 1;
+                break;
+            case 'O':
+                options.opa = 1;
+                break;
+            case 'P': {
+                unsigned long cores = strtoul(optarg, NULL, 10);
+                if (cores == 0 || cores > PARTITION_MAX_CORES) {
+                    fprintf(stderr, "%s: -P needs 1 to %u cores\n", argv[0], PARTITION_MAX_CORES);
+                    exit(-1);
+                }
+                options.cores = (unsigned int) cores;
+                break;
+            }
+            case 'X':
+                options.simulate = 1;
+                break;
+            case 'F':
+                options.fused = 1;
+                break;
+            case 'A':
+                options.batch = 1;
+                break;
+            case 'I':
+                for (unsigned f = 1; f < NUM_INSTRUMENT_FORMATS; f++) {
+                    if (strcmp(optarg, instrument_formats[f].name) == 0) {
+                        options.instrument = f;
+                    }
+                }
+                if (options.instrument == INSTRUMENT_NONE) {
+                    fprintf(stderr, "%s: unknown instrumentation format '%s'\n", argv[0], optarg);
+                    exit(-1);
+                }
+                if (!instrument_available()) {
+                    fprintf(stderr, "%s: -I needs a build with ANALYSIS_STATS, e.g. make STATS=1\n", argv[0]);
+                    exit(-1);
+                }
+                break;
+            case 'c':
+                options.memo = 1;
+                break;
+            case 'C':
+                options.memo = 1;
+                options.memo_file = optarg;
+                break;
+            case 's':
+                options.streaming = 1;
+                break;
+            case 'm':
+                options.mapped = 1;
+                break;
+            case 'K':
+                // Force an RM/DM interference kernel instead of the best available
+                if (interference_parse(optarg, &kernel) != 0 || !interference_use(kernel)) {
+                    fprintf(stderr, "%s: kernel '%s' not available\n", argv[0], optarg);
+                    exit(-1);
+                }
+                break;
+            case 'M':
+                // Exact RM/DM test, picked per set by estimated cost by default
+                if (rta_method_parse(optarg, &method) != 0) {
+                    fprintf(stderr, "%s: unknown exact test '%s'\n", argv[0], optarg);
+                    exit(-1);
+                }
+                rta_method_use(method);
+                break;
+            case 'L':
+                // Protocol behind the critical sections' blocking terms, PIP by default
+                if (blocking_parse(optarg, &protocol) != 0) {
+                    fprintf(stderr, "%s: unknown locking protocol '%s'\n", argv[0], optarg);
+                    exit(-1);
+                }
+                blocking_use(protocol);
+                break;
+            case 'E':
+                // EDF demand check, QPA by default
+                if (strcmp(optarg, "forward") == 0) {
+                    options.edf_forward = 1;
+                } else if (strcmp(optarg, "qpa") != 0) {
+                    fprintf(stderr, "%s: unknown EDF method '%s'\n", argv[0], optarg);
+                    exit(-1);
+                }
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-v] [-i] [-j workers] [-s | -m] [-K kernel] [-M auto|rta|points] [-E qpa|forward] "
+                                "[-L pip|pcp|none] [-B binary output] [-T text output] "
+                                "[-G sets [-n tasks] [-D wide|tight] [-R seed]] "
+                                "[-b bin width] [-q] [-N] [-W] [-S] [-O] [-P cores] [-c | -C memo file] [-X] [-I csv|json|hist] [-F] [-A] [input file]\n", argv[0]);
+                exit(-1);
+        }
+    }
+
+    if (optind < argc) {
+        options.filename = argv[optind];
+    }
 
-    char line[256];  // Should be long enough
+    if (options.ticks) {
+        algorithms[0].analyze = options.edf_forward ? edf_forward_analysis_ticks : edf_analysis_ticks;
+        algorithms[1].analyze = rm_analysis_ticks;
+        algorithms[2].analyze = dm_analysis_ticks;
+    } else if (options.edf_forward) {
+        algorithms[0].analyze = edf_forward_analysis;
+    }
+
+    if (options.generate && (options.streaming || options.mapped || options.filename != NULL)) {
+        fprintf(stderr, "%s: -G generates its own input, drop -s, -m and the input file\n", argv[0]);
+        exit(-1);
+    }
 
-    // First line designating number of task sets
-    if(!fgets(line, sizeof(line), file)) exit(-1);
-    program.num_task_sets = (int) strtoul(line, NULL, 10);
-    program.task_sets = malloc(program.num_task_sets * sizeof(TaskSet));
+    if (options.generate && (options.generator.num_task_sets == 0 || options.generator.num_tasks == 0)) {
+        fprintf(stderr, "%s: -G and -n need at least one task set and task\n", argv[0]);
+        exit(-1);
+    }
 
-    // Task set declaration
-    for (unsigned int i = 0; i < program.num_task_sets; i++) {
+    if ((options.wcrt || options.sensitivity || options.opa || options.cores || options.simulate
+         || options.instrument || options.batch) && options.streaming) {
+        fprintf(stderr, "%s: -W, -S, -O, -P, -X, -I and -A can't be combined with -s\n", argv[0]);
+        exit(-1);
+    }
 
-        TaskSet *task_set = &program.task_sets[i];
+    // Fused analysis runs the double precision analyses with QPA, and as one
+    // call it can't be timed or counted per algorithm
+    if (options.fused && (options.ticks || options.edf_forward || options.instrument)) {
+        fprintf(stderr, "%s: -F can't be combined with -i, -E forward or -I\n", argv[0]);
+        exit(-1);
+    }
+    analyze_fused = options.fused;
 
-        // Get line declaring task set
-        if(!fgets(line, sizeof(line), file)) exit(-1);
+    // The batch decides sets for the double precision analyses only
+    if (options.batch && (options.ticks || options.edf_forward || options.instrument)) {
+        fprintf(stderr, "%s: -A can't be combined with -i, -E forward or -I\n", argv[0]);
+        exit(-1);
+    }
 
-        // Set up task set
-        task_set->num_tasks = (unsigned int) strtol(line, NULL, 10);
-        task_set->tasks = malloc(task_set->num_tasks * sizeof(Task));
+    if (options.instrument && options.memo) {
+        fprintf(stderr, "%s: -I counts the analyses' work, which the memo skips, drop -c and -C\n", argv[0]);
+        exit(-1);
+    }
 
-        // Task declaration
-        for (unsigned int j = 0; j < task_set->num_tasks; j++) {
+    if (options.streaming && (options.binary_output != NULL || options.text_output != NULL)) {
+        fprintf(stderr, "%s: -B and -T can't be combined with -s\n", argv[0]);
+        exit(-1);
+    }
 
-            // Get line declaring task
-            if(!fgets(line, sizeof(line), file)) exit(-1);
+    if (options.mapped && options.filename == NULL) {
+        fprintf(stderr, "%s: -m needs an input file, stdin can't be mapped\n", argv[0]);
+        exit(-1);
+    }
 
-            Task *task = &task_set->tasks[j];
+    return options;
+}
 
-            char *state;
+ProgramInfo loadMapped(Options *options) {
 
-            // WCET
-            task->wcet = strtod(line, &state);
+    MappedInput input;
+    ProgramInfo program;
+    ParseError error;
 
-            // Deadline
-            task->deadline = strtod(state, &state);
+    if (mapInput(options->filename, &input) != 0) {
+        perror(options->filename);
+        exit(-1);
+    }
 
-            // Period
-            task->period = strtod(state, &state);
+    // Binary files are used in place and stay mapped until exit
+    if (isBinaryInput(&input)) {
+        if (parseBinary(&input, &program, &error) != 0) {
+            fprintf(stderr, "%s: byte %zu: %s\n", options->filename, error.offset, error.message);
+            exit(-1);
         }
+        return program;
+    }
 
+    // The file is split into one chunk per worker
+    if (parseMapped(&input, options->num_workers, &program, &error) != 0) {
+        fprintf(stderr, "%s: byte %zu: %s\n", options->filename, error.offset, error.message);
+        exit(-1);
     }
 
+    unmapInput(&input);
     return program;
 }
 
-void writeFile(analysis_results results, FILE *file) {
+// Writes the loaded task sets to the -B and -T files
+void convertProgram(ProgramInfo *program, Options *options) {
 
-    fprintf(file, "%i %f\n", results.is_schedulable, results.utilization);
+    char *outputs[] = {options->binary_output, options->text_output};
+
+    for (unsigned i = 0; i < 2; i++) {
+
+        if (outputs[i] == NULL) {
+            continue;
+        }
+
+        FILE *file = fopen(outputs[i], i == 0 ? "wb" : "w");
+        if (file == NULL || (i == 0 ? writeBinary(program, file) : writeTaskSets(program, file)) != 0
+            || fclose(file) != 0) {
+            perror(outputs[i]);
+            exit(-1);
+        }
+    }
+}
+
+// Generates every set up front into one task array, in parallel
+ProgramInfo generateProgram(Options *options) {
+
+    GeneratorConfig *config = &options->generator;
+    ProgramInfo program = {config->num_task_sets, malloc(config->num_task_sets * sizeof(TaskSet))};
+    Task *tasks = malloc((size_t) config->num_task_sets * config->num_tasks * sizeof(Task));
+
+    for (unsigned i = 0; i < program.num_task_sets; i++) {
+        program.task_sets[i].num_tasks = config->num_tasks;
+        program.task_sets[i].tasks = tasks + (size_t) i * config->num_tasks;
+        program.task_sets[i].ticks = NULL;
+        program.task_sets[i].num_sections = 0;
+        program.task_sets[i].sections = NULL;
+    }
+
+    AnalysisJob job = {&program, config};
+    parallel_for(options->num_workers, program.num_task_sets, PARALLEL_GRAIN, generateRange, &job);
+    return program;
+}
+
+void generateRange(size_t begin, size_t end, unsigned worker, void *ctx) {
+
+    AnalysisJob *job = ctx;
+    Rng rng;
+
+    for (size_t i = begin; i < end; i++) {
+        generate_task_set(job->generator, (unsigned) i, &rng, job->program->task_sets[i].tasks);
+    }
+}
+
+// Fills task_set->ticks from ticks[], giving up on values that aren't whole ticks
+void convertToTicks(TaskSet *task_set, unsigned int index, TaskTicks *ticks) {
+
+    unsigned int bad_task;
+
+    if (task_set->num_sections > 0) {
+        fprintf(stderr, "task set %u: critical sections aren't supported in tick mode\n", index);
+        exit(-1);
+    }
+
+    task_set->ticks = ticks;
+    if (ticks_convert(task_set, ticks, &bad_task) != 0) {
+        fprintf(stderr, "task set %u, task %u: parameters aren't whole multiples of 1/%d\n",
+                index, bad_task, TICKS_PER_UNIT);
+        exit(-1);
+    }
+}
+
+/*
+ * records, if not NULL, gets every algorithm's counters. decided, if not
+ * NULL, marks the results batch_sufficient already filled in, which are
+ * used as they are.
+ */
+void analyzeTaskSet(TaskSet *task_set, analysis_results *results, AnalysisRecord *records, Memo *memo,
+                    const unsigned char *decided, WorkerStats *stats, WorkerScratch *scratch) {
+
+    // The memo key leaves critical sections out, so sets with any skip it,
+    // as do sets whose priorities tie
+    MemoKey key;
+    int memoized = memo != NULL && task_set->num_sections == 0
+                   && memo_key(task_set, task_set->ticks != NULL, scratchTasks(scratch, task_set->num_tasks), &key);
+    int known = 0;
+
+    if (memoized) {
+        known = memo_lookup(memo, &key, results);
+        if (known) {
+            stats->memo_hits++;
+        } else {
+            stats->memo_misses++;
+        }
+    }
+
+    if (known) {
+        double utilization = totalUtilization(task_set);
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            results[a].utilization = utilization;
+        }
+    }
+
+    // Whatever the batch left undecided
+    unsigned undecided = NUM_ALGORITHMS;
+    for (unsigned a = 0; a < NUM_ALGORITHMS && decided != NULL && !known; a++) {
+        stats->batch_decided[a] += decided[a];
+        undecided -= decided[a];
+    }
+
+    if (analyze_fused && !known && undecided > 0) {
+        double start = now();
+        fused_analysis(task_set, results);
+        stats->fused_seconds += now() - start;
+    }
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS && !known && !analyze_fused; a++) {
+
+        if (decided != NULL && decided[a]) {
+            continue;
+        }
+
+        if (records != NULL) {
+            instrument_begin(records[a].counters.task_iterations, task_set->num_tasks);
+        }
+
+        double start = now();
+        results[a] = algorithms[a].analyze(task_set);
+        double seconds = now() - start;
+        stats->seconds[a] += seconds;
+
+        if (records != NULL) {
+            instrument_end(&records[a].counters);
+            records[a].nanoseconds = (unsigned long) (seconds * 1e9);
+        }
+    }
+
+    // Only verdicts any order of the tasks would get are kept, so a set
+    // that's found always has them
+    if (memoized && !known && !orderSensitive(task_set, results)) {
+        memo_insert(memo, &key, results);
+    }
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+        stats->tiers[a][results[a].tier]++;
+        stats->methods[a][results[a].method]++;
+        if (stats->bins[a].width > 0) {
+            bins_add(&stats->bins[a], results[a].utilization, results[a].is_schedulable);
+        }
+    }
+}
+
+/*
+ * 1 if task_set's results could come out differently for its tasks in
+ * another order, as they're summed in input order: the utilization or EDF's
+ * density lies within rounding of 1, or RM's or DM's sums of a bound or
+ * response time, see rta_order_sensitive. Tick analyses sum exactly, only
+ * their bounds are taken in doubles.
+ */
+int orderSensitive(TaskSet *task_set, analysis_results *results) {
+
+    double utilization = totalUtilization(task_set), density = 0.0;
+
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        Task *task = &task_set->tasks[i];
+        density += task->wcet > 0 ? task->wcet / fmin(task->period, task->deadline) : 0.0;
+    }
+
+    if (fabs(utilization - 1.0) <= 1e-6 || fabs(density - 1.0) <= 1e-6) {
+        return 1;
+    }
+
+    // RM and DM follow EDF in algorithms[]
+    for (unsigned k = 0; k < NUM_RESPONSE_TIMES; k++) {
+        int exact = task_set->ticks == NULL && results[k + 1].tier == TIER_EXACT;
+        if (rta_order_sensitive(task_set, response_times[k].order, exact)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Summed in input order like the analyses do, so it matches theirs exactly
+double totalUtilization(TaskSet *task_set) {
+
+    double utilization = 0.0;
+
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        utilization += task_set->tasks[i].wcet / task_set->tasks[i].period;
+    }
+
+    return utilization;
+}
+
+void analyzeRange(size_t begin, size_t end, unsigned worker, void *ctx) {
+
+    AnalysisJob *job = ctx;
+
+    // Sets go through the batch's cheap tests together, one at a time without it
+    unsigned int batch = job->batch ? BATCH_SETS : 1;
+    analysis_results batched[BATCH_SETS][NUM_ALGORITHMS];
+    unsigned char decided[BATCH_SETS][NUM_ALGORITHMS];
+
+    unsigned int num_tasks = job->generator != NULL ? job->generator->num_tasks : 0;
+    Task *tasks = job->scratch[worker].tasks;
+    TaskTicks *ticks = job->scratch[worker].ticks;
+    TaskSet generated[BATCH_SETS];
+    Rng rng;
+
+    for (size_t first = begin; first < end; first += batch) {
+
+        size_t last = first + batch < end ? first + batch : end;
+        TaskSet *task_sets = &job->program->task_sets[first];
+
+        if (job->generator != NULL) {
+            task_sets = generated;
+            for (size_t i = first; i < last; i++) {
+                TaskSet *task_set = &generated[i - first];
+                *task_set = (TaskSet) {num_tasks, tasks + (i - first) * num_tasks, NULL};
+                generate_task_set(job->generator, (unsigned) i, &rng, task_set->tasks);
+                if (job->ticks) {
+                    convertToTicks(task_set, (unsigned) i, ticks + (i - first) * num_tasks);
+                }
+            }
+        }
+
+        if (job->batch) {
+            double start = now();
+            batch_sufficient(task_sets, (unsigned int) (last - first), &job->scratch[worker].batch, batched[0],
+                             decided[0]);
+            job->stats[worker].batch_seconds += now() - start;
+        }
+
+        for (size_t i = first; i < last; i++) {
+            analyzeSet(job, &task_sets[i - first], i, batched[i - first], job->batch ? decided[i - first] : NULL,
+                       worker);
+        }
+    }
+}
+
+// Everything asked for of set i, its results of the batch already in results
+void analyzeSet(AnalysisJob *job, TaskSet *task_set, size_t i, analysis_results *results,
+                const unsigned char *decided, unsigned worker) {
+
+    AnalysisRecord *records = NULL;
+    if (job->records != NULL) {
+        records = job->records + i * NUM_ALGORITHMS;
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            records[a].counters.task_iterations =
+                    job->task_iterations + job->task_offsets[i] * NUM_ALGORITHMS + a * task_set->num_tasks;
+        }
+    }
+
+    analyzeTaskSet(task_set, results, records, job->memo, decided, &job->stats[worker], &job->scratch[worker]);
+
+    for (unsigned k = 0; k < NUM_RESPONSE_TIMES && job->wcrt[k] != NULL; k++) {
+        rta_response_times(task_set, response_times[k].order, job->wcrt[k] + job->task_offsets[i]);
+    }
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS && job->sensitivity != NULL; a++) {
+        job->sensitivity[i * NUM_ALGORITHMS + a] = algorithms[a].sensitivity(task_set);
+    }
+
+    if (job->opa != NULL) {
+        job->opa[i] = opa_assign(task_set, job->opa_order + job->task_offsets[i]);
+    }
+
+    for (unsigned h = 0; h < NUM_HEURISTICS && job->partition != NULL; h++) {
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            job->partition[(i * NUM_HEURISTICS + h) * NUM_ALGORITHMS + a] =
+                    (unsigned char) partition_schedulable(task_set, &job->partition_scratch[worker],
+                                                          heuristics[h].heuristic, algorithms[a].partition);
+        }
+    }
+
+    if (job->simulation != NULL) {
+        simulateTaskSet(task_set, &job->scratch[worker], job->simulation + i * NUM_ALGORITHMS);
+    }
 
-}
\ No newline at end of file
+    for (unsigned a = 0; a < NUM_ALGORITHMS && job->results[a] != NULL; a++) {
+        job->results[a][i] = results[a];
+    }
+}
+
+/*
+ * Reads, analyzes and writes one task set at a time instead of loading the
+ * whole file first. Memory stays bounded by the number of pipeline slots and
+ * results are written as soon as each set's turn comes up.
+ */
+void runStreaming(Options *options) {
+
+    StreamJob job = {openInput(options->filename)};
+    job.ticks = options->ticks;
+    readTaskSetCount(job.input, &job.sets_left);
+    unsigned int num_task_sets = job.sets_left;
+
+    if (options->npy && !options->quiet) {
+        job.columns = openColumns();
+    }
+    for (unsigned a = 0; a < NUM_ALGORITHMS && !options->quiet && !options->npy; a++) {
+        job.results[a] = fopen(algorithms[a].results_file, "w+");
+    }
+    job.stats = createStats(options);
+    job.scratch = createScratch(options, 0);
+    job.memo = openMemo(options);
+
+    PipelineStages stages = {streamRead, streamAnalyze, streamWrite, &job};
+
+    double start = now();
+    pipeline_run(options->num_workers * STREAM_SLOTS_PER_WORKER, options->num_workers,
+                 NUM_ALGORITHMS, &stages);
+    double wall_seconds = now() - start;
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS && job.results[a] != NULL; a++) {
+        fclose(job.results[a]);
+    }
+    if (job.columns != NULL) {
+        closeColumns(job.columns);
+    }
+
+    if (options->bin_width > 0) {
+        writeSummary(job.stats, options);
+    }
+
+    if (options->verbose) {
+        reportStats(job.stats, options->num_workers, num_task_sets, wall_seconds);
+    }
+
+    closeMemo(job.memo, options);
+    freeScratch(job.scratch, options);
+    free(job.stats);
+}
+
+int streamRead(PipelineSlot *slot, void *ctx) {
+
+    StreamJob *job = ctx;
+
+    if (job->sets_left == 0) {
+        return 0;
+    }
+
+    arena_reset(&slot->arena);
+    readTaskSet(job->input, &slot->task_set, &slot->arena);
+
+    if (job->ticks) {
+        TaskTicks *ticks = arena_alloc(&slot->arena, slot->task_set.num_tasks * sizeof(TaskTicks));
+        if (ticks == NULL) {
+            fprintf(stderr, "task set %u: out of memory\n", job->sets_read);
+            exit(-1);
+        }
+        convertToTicks(&slot->task_set, job->sets_read, ticks);
+    }
+
+    job->sets_left--;
+    job->sets_read++;
+    return 1;
+}
+
+void streamAnalyze(PipelineSlot *slot, unsigned worker, void *ctx) {
+
+    StreamJob *job = ctx;
+    analyzeTaskSet(&slot->task_set, slot->results, NULL, job->memo, NULL, &job->stats[worker],
+                   &job->scratch[worker]);
+
+}
+
+void streamWrite(PipelineSlot *slot, void *ctx) {
+
+    StreamJob *job = ctx;
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS && job->results[a] != NULL; a++) {
+        writeFile(slot->results[a], job->results[a]);
+    }
+    for (unsigned a = 0; a < NUM_ALGORITHMS && job->columns != NULL; a++) {
+        appendColumns(&job->columns[a], &slot->results[a], 1);
+    }
+}
+
+WorkerStats *createStats(Options *options) {
+
+    WorkerStats *stats = calloc(options->num_workers, sizeof(WorkerStats));
+
+    for (unsigned w = 0; w < options->num_workers; w++) {
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            bins_init(&stats[w].bins[a], options->bin_width);
+        }
+    }
+
+    return stats;
+}
+
+// Tasks in the largest set, of -G or the file
+unsigned int maxTasks(ProgramInfo *program, Options *options) {
+
+    unsigned int max_tasks = options->generate ? options->generator.num_tasks : 0;
+
+    for (unsigned i = 0; i < program->num_task_sets && !options->generate; i++) {
+        if (program->task_sets[i].num_tasks > max_tasks) {
+            max_tasks = program->task_sets[i].num_tasks;
+        }
+    }
+
+    return max_tasks;
+}
+
+// max_tasks sizes the -A and -X scratch, which streaming doesn't have
+WorkerScratch *createScratch(Options *options, unsigned int max_tasks) {
+
+    WorkerScratch *scratch = calloc(options->num_workers, sizeof(WorkerScratch));
+    size_t num_tasks = (size_t) (options->batch ? BATCH_SETS : 1) * options->generator.num_tasks;
+
+    for (unsigned w = 0; w < options->num_workers && options->generate; w++) {
+        scratch[w].tasks = malloc((num_tasks + 1) * sizeof(Task));
+        scratch[w].ticks = options->ticks ? malloc((num_tasks + 1) * sizeof(TaskTicks)) : NULL;
+        if (scratch[w].tasks == NULL || (options->ticks && scratch[w].ticks == NULL)) {
+            fprintf(stderr, "-G: out of memory for sets of %u tasks\n", options->generator.num_tasks);
+            exit(-1);
+        }
+    }
+
+    for (unsigned w = 0; w < options->num_workers && options->batch; w++) {
+        if (batch_scratch_init(&scratch[w].batch, max_tasks) != 0) {
+            fprintf(stderr, "-A: out of memory for sets of %u tasks\n", max_tasks);
+            exit(-1);
+        }
+    }
+
+    for (unsigned w = 0; w < options->num_workers && options->simulate; w++) {
+        scratch[w].sim_ticks = malloc(((size_t) max_tasks + 1) * sizeof(TaskTicks));
+        if (scratch[w].sim_ticks == NULL || sim_scratch_init(&scratch[w].sim, max_tasks) != 0) {
+            fprintf(stderr, "-X: out of memory for sets of %u tasks\n", max_tasks);
+            exit(-1);
+        }
+    }
+
+    return scratch;
+}
+
+// Room for num_tasks tasks in scratch->sorted
+Task *scratchTasks(WorkerScratch *scratch, unsigned int num_tasks) {
+
+    if (num_tasks > scratch->capacity) {
+        free(scratch->sorted);
+        scratch->sorted = malloc((num_tasks + 1) * sizeof(Task));
+        if (scratch->sorted == NULL) {
+            fprintf(stderr, "out of memory for a set of %u tasks\n", num_tasks);
+            exit(-1);
+        }
+        scratch->capacity = num_tasks;
+    }
+
+    return scratch->sorted;
+}
+
+void freeScratch(WorkerScratch *scratch, Options *options) {
+
+    for (unsigned w = 0; w < options->num_workers; w++) {
+        free(scratch[w].sorted);
+        free(scratch[w].tasks);
+        free(scratch[w].ticks);
+        batch_scratch_free(&scratch[w].batch);
+        sim_scratch_free(&scratch[w].sim);
+        free(scratch[w].sim_ticks);
+    }
+
+    free(scratch);
+}
+
+// Merges every worker's bins into the first worker's and writes the table
+void writeSummary(WorkerStats *stats, Options *options) {
+
+    const char *names[NUM_ALGORITHMS];
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+        names[a] = algorithms[a].name;
+        for (unsigned w = 1; w < options->num_workers; w++) {
+            bins_merge(&stats[0].bins[a], &stats[w].bins[a]);
+        }
+    }
+
+    FILE *file = fopen(SUMMARY_FILE, "w+");
+    if (file == NULL) {
+        perror(SUMMARY_FILE);
+        exit(-1);
+    }
+
+    bins_write(file, stats[0].bins, names, NUM_ALGORITHMS);
+    fclose(file);
+}
+
+void reportStats(WorkerStats *stats, unsigned num_workers, unsigned num_task_sets,
+                 double wall_seconds) {
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+
+        double cpu_seconds = 0.0;
+        unsigned long tiers[NUM_TIERS] = {0};
+        unsigned long methods[NUM_METHODS] = {0};
+
+        for (unsigned w = 0; w < num_workers; w++) {
+            cpu_seconds += stats[w].seconds[a];
+            for (unsigned t = 0; t < NUM_TIERS; t++) {
+                tiers[t] += stats[w].tiers[a][t];
+            }
+            for (unsigned m = 0; m < NUM_METHODS; m++) {
+                methods[m] += stats[w].methods[a][m];
+            }
+        }
+
+        // Rate as if the algorithm had all workers to itself, fused analyses
+        // are only timed together
+        fprintf(stderr, "%-4s %u sets", algorithms[a].name, num_task_sets);
+        if (!analyze_fused) {
+            fprintf(stderr, "  %.3f s cpu  %.0f sets/s", cpu_seconds,
+                    cpu_seconds > 0 ? num_task_sets * num_workers / cpu_seconds : 0.0);
+        }
+
+        // Sets decided by U > 1, by a bound, and by the exact test
+        fprintf(stderr, "  decided by utilization %lu  bound %lu  exact %lu",
+                tiers[TIER_UTILIZATION], tiers[TIER_BOUND], tiers[TIER_EXACT]);
+
+        // Which exact test RM and DM ran, memo hits not counted
+        if (methods[METHOD_RTA] + methods[METHOD_POINTS] > 0) {
+            fprintf(stderr, " (rta %lu  points %lu)", methods[METHOD_RTA], methods[METHOD_POINTS]);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    if (analyze_fused) {
+        double cpu_seconds = 0.0;
+        for (unsigned w = 0; w < num_workers; w++) {
+            cpu_seconds += stats[w].fused_seconds;
+        }
+        fprintf(stderr, "fused %u sets  %.3f s cpu  %.0f sets/s\n", num_task_sets, cpu_seconds,
+                cpu_seconds > 0 ? num_task_sets * num_workers / cpu_seconds : 0.0);
+    }
+
+    double batch_seconds = 0.0;
+    unsigned long batch_decided[NUM_ALGORITHMS] = {0};
+    for (unsigned w = 0; w < num_workers; w++) {
+        batch_seconds += stats[w].batch_seconds;
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            batch_decided[a] += stats[w].batch_decided[a];
+        }
+    }
+
+    // Verdicts the batch's cheap tests settled, which the lines above count
+    // among their tiers but not their time
+    if (batch_seconds > 0) {
+        fprintf(stderr, "batch %.3f s cpu  decided", batch_seconds);
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            fprintf(stderr, "  %s %lu", algorithms[a].name, batch_decided[a]);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    unsigned long hits = 0, misses = 0;
+    for (unsigned w = 0; w < num_workers; w++) {
+        hits += stats[w].memo_hits;
+        misses += stats[w].memo_misses;
+    }
+
+    if (hits + misses > 0) {
+        fprintf(stderr, "memo %lu hits  %lu misses  %.1f%% hit rate\n", hits, misses,
+                100.0 * hits / (hits + misses));
+    }
+
+    fprintf(stderr, "all  %u sets  %.3f s wall  %u workers  %.0f sets/s\n",
+            num_task_sets, wall_seconds, num_workers,
+            wall_seconds > 0 ? num_task_sets / wall_seconds : 0.0);
+}
+
+double now(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+
+}
+
+void writeFile(analysis_results results, FILE *file) {
+
+    fprintf(file, "%i %f\n", results.is_schedulable, results.utilization);
+
+}
+
+static void openColumn(NpyFile *npy, const char *algorithm, const char *column,
+                       const char *descr, size_t item_size) {
+
+    char path[256];
+    snprintf(path, sizeof(path), RESULTS_COLUMN, algorithm, column);
+
+    if (npy_open(npy, path, descr, item_size) != 0) {
+        perror(path);
+        exit(-1);
+    }
+}
+
+static void closeColumn(NpyFile *npy) {
+
+    if (npy_close(npy) != 0) {
+        perror("out/");
+        exit(-1);
+    }
+}
+
+// Opens the schedulable and utilization columns of every algorithm
+ResultColumns *openColumns(void) {
+
+    ResultColumns *columns = malloc(NUM_ALGORITHMS * sizeof(ResultColumns));
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+        openColumn(&columns[a].schedulable, algorithms[a].name, "schedulable", NPY_UINT8, 1);
+        openColumn(&columns[a].utilization, algorithms[a].name, "utilization", NPY_FLOAT64,
+                   sizeof(double));
+    }
+
+    return columns;
+}
+
+void appendColumns(ResultColumns *columns, analysis_results *results, size_t count) {
+
+    // Split into columns through small buffers rather than a copy of everything
+    uint8_t schedulable[4096];
+    double utilization[4096];
+
+    for (size_t i = 0; i < count; i += 4096) {
+
+        size_t n = count - i < 4096 ? count - i : 4096;
+
+        for (size_t j = 0; j < n; j++) {
+            schedulable[j] = (uint8_t) results[i + j].is_schedulable;
+            utilization[j] = results[i + j].utilization;
+        }
+
+        if (npy_append(&columns->schedulable, schedulable, n) != 0
+            || npy_append(&columns->utilization, utilization, n) != 0) {
+            perror("out/");
+            exit(-1);
+        }
+    }
+}
+
+void closeColumns(ResultColumns *columns) {
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+        closeColumn(&columns[a].schedulable);
+        closeColumn(&columns[a].utilization);
+    }
+
+    free(columns);
+}
+
+// One flat column per priority order, every task in input order
+void writeResponseTimes(AnalysisJob *job, size_t num_tasks) {
+
+    for (unsigned k = 0; k < NUM_RESPONSE_TIMES; k++) {
+
+        NpyFile npy;
+        openColumn(&npy, response_times[k].name, "wcrt", NPY_FLOAT64, sizeof(double));
+
+        if (npy_append(&npy, job->wcrt[k], num_tasks) != 0) {
+            perror("out/");
+            exit(-1);
+        }
+
+        closeColumn(&npy);
+    }
+}
+
+// One line per set with each algorithm's breakdown factor
+void writeSensitivity(AnalysisJob *job) {
+
+    FILE *file = fopen(SENSITIVITY_FILE, "w+");
+    if (file == NULL) {
+        perror(SENSITIVITY_FILE);
+        exit(-1);
+    }
+
+    for (unsigned i = 0; i < job->program->num_task_sets; i++) {
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            fprintf(file, a + 1 < NUM_ALGORITHMS ? "%f " : "%f\n", job->sensitivity[i * NUM_ALGORITHMS + a]);
+        }
+    }
+
+    fclose(file);
+}
+
+// Verdict and utilization like the other results, then the order found
+void writeOpa(AnalysisJob *job) {
+
+    FILE *file = fopen(RESULTS_FILE_OPA, "w+");
+    if (file == NULL) {
+        perror(RESULTS_FILE_OPA);
+        exit(-1);
+    }
+
+    for (unsigned i = 0; i < job->program->num_task_sets; i++) {
+
+        fprintf(file, "%i %f", job->opa[i].is_schedulable, job->opa[i].utilization);
+
+        size_t begin = job->task_offsets[i], end = job->task_offsets[i + 1];
+        for (size_t k = begin; k < end && job->opa[i].is_schedulable; k++) {
+            fprintf(file, " %u", job->opa_order[k]);
+        }
+        fputc('\n', file);
+    }
+
+    fclose(file);
+}
+
+// Header naming the columns, then one 0/1 line per set
+void writePartition(AnalysisJob *job) {
+
+    FILE *file = fopen(PARTITION_FILE, "w+");
+    if (file == NULL) {
+        perror(PARTITION_FILE);
+        exit(-1);
+    }
+
+    fprintf(file, "# %u cores:", job->cores);
+    for (unsigned h = 0; h < NUM_HEURISTICS; h++) {
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+            fprintf(file, " %s_%s", heuristics[h].name, algorithms[a].name);
+        }
+    }
+    fputc('\n', file);
+
+    size_t columns = NUM_HEURISTICS * NUM_ALGORITHMS;
+    for (size_t i = 0; i < job->program->num_task_sets; i++) {
+        for (size_t k = 0; k < columns; k++) {
+            fprintf(file, k + 1 < columns ? "%u " : "%u\n", job->partition[i * columns + k]);
+        }
+    }
+
+    fclose(file);
+}
+
+// Runs every algorithm's schedule, in ticks whether or not the analyses are
+void simulateTaskSet(TaskSet *task_set, WorkerScratch *scratch, SimResult *results) {
+
+    TaskTicks *ticks = scratch->sim_ticks;
+    TaskSet converted = *task_set;
+    unsigned int bad_task;
+
+    if (converted.ticks == NULL) {
+        converted.ticks = ticks;
+    }
+
+    // Sets not in whole ticks, or whose critical sections the simulator
+    // doesn't model, are left undecided
+    int usable = task_set->num_sections == 0
+                 && (task_set->ticks != NULL || ticks_convert(task_set, ticks, &bad_task) == 0);
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+        results[a] = usable ? sim_run(&converted, &scratch->sim, algorithms[a].policy, SIMULATION_MAX_JOBS)
+                            : (SimResult) {SIM_UNDECIDED, SIM_NO_TASK, 0, 0};
+    }
+}
+
+/*
+ * Writes every set's simulated outcome per algorithm, 1 for no deadline
+ * missed, 0 for a miss and -1 for undecided, with the task that missed first
+ * (-1 for none) and the time of the miss or of the end of the simulation.
+ * Verdicts the simulation contradicts are listed on stderr.
+ */
+void writeSimulation(AnalysisJob *job) {
+
+    static const int outcomes[] = {1, 0, -1};
+
+    FILE *file = fopen(SIMULATION_FILE, "w+");
+    if (file == NULL) {
+        perror(SIMULATION_FILE);
+        exit(-1);
+    }
+
+    fprintf(file, "#");
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+        fprintf(file, " %s %s_task %s_time", algorithms[a].name, algorithms[a].name, algorithms[a].name);
+    }
+    fputc('\n', file);
+
+    unsigned long agree[NUM_ALGORITHMS] = {0}, undecided[NUM_ALGORITHMS] = {0};
+
+    for (size_t i = 0; i < job->program->num_task_sets; i++) {
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+
+            SimResult *result = &job->simulation[i * NUM_ALGORITHMS + a];
+            int outcome = outcomes[result->outcome];
+
+            fprintf(file, a + 1 < NUM_ALGORITHMS ? "%d %d %.2f " : "%d %d %.2f\n", outcome,
+                    result->task == SIM_NO_TASK ? -1 : (int) result->task,
+                    (double) result->time / TICKS_PER_UNIT);
+
+            if (result->outcome == SIM_UNDECIDED) {
+                undecided[a]++;
+            } else if (outcome == job->results[a][i].is_schedulable) {
+                agree[a]++;
+            } else {
+                fprintf(stderr, "set %zu: %s analysis says %d, simulation %d\n", i, algorithms[a].name,
+                        job->results[a][i].is_schedulable, outcome);
+            }
+        }
+    }
+
+    fclose(file);
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+        fprintf(stderr, "sim  %-4s agree %lu  disagree %lu  undecided %lu\n", algorithms[a].name, agree[a],
+                job->program->num_task_sets - agree[a] - undecided[a], undecided[a]);
+    }
+}
+
+void writeInstrumentation(AnalysisJob *job, unsigned int format) {
+
+    char path[64];
+    snprintf(path, sizeof(path), INSTRUMENT_FILE, instrument_formats[format].extension);
+
+    FILE *file = fopen(path, "w+");
+    if (file == NULL) {
+        perror(path);
+        exit(-1);
+    }
+
+    if (format == INSTRUMENT_CSV) {
+        writeRecordsCsv(job, file);
+    } else if (format == INSTRUMENT_JSON) {
+        writeRecordsJson(job, file);
+    } else {
+        writeHistograms(job, file);
+    }
+
+    fclose(file);
+}
+
+// One row per set and algorithm, the per-task iterations separated by ';'
+void writeRecordsCsv(AnalysisJob *job, FILE *file) {
+
+    fprintf(file, "set,algorithm,nanoseconds,iterations,task_iterations,busy_period,checkpoints\n");
+
+    for (size_t i = 0; i < job->program->num_task_sets; i++) {
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+
+            AnalysisRecord *record = &job->records[i * NUM_ALGORITHMS + a];
+            AnalysisCounters *counters = &record->counters;
+
+            fprintf(file, "%zu,%s,%lu,%lu,", i, algorithms[a].name, record->nanoseconds, counters->iterations);
+            for (unsigned k = 0; k < counters->num_tasks; k++) {
+                fprintf(file, k > 0 ? ";%u" : "%u", counters->task_iterations[k]);
+            }
+            fprintf(file, ",%.10g,%lu\n", counters->busy_period, counters->checkpoints);
+        }
+    }
+}
+
+// An array with one object per set, holding one object per algorithm
+void writeRecordsJson(AnalysisJob *job, FILE *file) {
+
+    fprintf(file, "[\n");
+
+    for (size_t i = 0; i < job->program->num_task_sets; i++) {
+
+        fprintf(file, "{\"set\": %zu", i);
+
+        for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+
+            AnalysisRecord *record = &job->records[i * NUM_ALGORITHMS + a];
+            AnalysisCounters *counters = &record->counters;
+
+            fprintf(file, ", \"%s\": {\"nanoseconds\": %lu, \"iterations\": %lu, \"task_iterations\": [",
+                    algorithms[a].name, record->nanoseconds, counters->iterations);
+            for (unsigned k = 0; k < counters->num_tasks; k++) {
+                fprintf(file, k > 0 ? ", %u" : "%u", counters->task_iterations[k]);
+            }
+            fprintf(file, "], \"busy_period\": %.10g, \"checkpoints\": %lu}",
+                    counters->busy_period, counters->checkpoints);
+        }
+
+        fprintf(file, i + 1 < job->program->num_task_sets ? "},\n" : "}\n");
+    }
+
+    fprintf(file, "]\n");
+}
+
+static unsigned histogramBucket(unsigned long value) {
+
+    unsigned bucket = 0;
+    while (value > 0) {
+        value >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/*
+ * Log2 histograms of each algorithm's nanoseconds, busy period and
+ * checkpoints per set, and of its iterations per task. One row per
+ * non-empty bucket, metrics that stayed 0 for every set are left out.
+ */
+void writeHistograms(AnalysisJob *job, FILE *file) {
+
+    static const char *metrics[] = {"nanoseconds", "task_iterations", "busy_period", "checkpoints"};
+    enum { NUM_METRICS = sizeof(metrics) / sizeof(metrics[0]) };
+
+    fprintf(file, "# algorithm metric from to count\n");
+
+    for (unsigned a = 0; a < NUM_ALGORITHMS; a++) {
+
+        unsigned long counts[NUM_METRICS][HISTOGRAM_BUCKETS] = {{0}};
+
+        for (size_t i = 0; i < job->program->num_task_sets; i++) {
+
+            AnalysisRecord *record = &job->records[i * NUM_ALGORITHMS + a];
+            AnalysisCounters *counters = &record->counters;
+
+            counts[0][histogramBucket(record->nanoseconds)]++;
+            for (unsigned k = 0; k < counters->num_tasks; k++) {
+                counts[1][histogramBucket(counters->task_iterations[k])]++;
+            }
+            counts[2][histogramBucket((unsigned long) counters->busy_period)]++;
+            counts[3][histogramBucket(counters->checkpoints)]++;
+        }
+
+        for (unsigned m = 0; m < NUM_METRICS; m++) {
+
+            unsigned long nonzero = 0;
+            for (unsigned b = 1; b < HISTOGRAM_BUCKETS; b++) {
+                nonzero += counts[m][b];
+            }
+            if (nonzero == 0) {
+                continue;
+            }
+
+            for (unsigned b = 0; b < HISTOGRAM_BUCKETS; b++) {
+                if (counts[m][b] > 0) {
+                    unsigned long from = b > 0 ? 1UL << (b - 1) : 0;
+                    unsigned long to = b > 0 ? (from << 1) - 1 : 0;
+                    fprintf(file, "%s %s %lu %lu %lu\n", algorithms[a].name, metrics[m], from, to, counts[m][b]);
+                }
+            }
+        }
+    }
+}
+
+// The -c memo, filled from the -C file if there is one, or NULL
+Memo *openMemo(Options *options) {
+
+    if (!options->memo) {
+        return NULL;
+    }
+
+    Memo *memo = memo_create(NUM_ALGORITHMS);
+
+    if (options->memo_file != NULL && memo_load(memo, options->memo_file) != 0) {
+        perror(options->memo_file);
+        exit(-1);
+    }
+
+    return memo;
+}
+
+// Saves the memo back to the -C file, new sets included
+void closeMemo(Memo *memo, Options *options) {
+
+    if (memo == NULL) {
+        return;
+    }
+
+    if (options->memo_file != NULL && memo_save(memo, options->memo_file) != 0) {
+        perror(options->memo_file);
+        exit(-1);
+    }
+
+    memo_free(memo);
+}
@@ -0,0 +1,384 @@
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "memo.h"
+
+// Independently locked tables, picked by the top bits of a key
+#define SHARD_BITS 6
+#define NUM_SHARDS (1u << SHARD_BITS)
+
+// Slots per shard to begin with, a power of 2 as capacities stay
+#define INITIAL_CAPACITY 256
+
+// Result bytes are never 0 for a stored key, so a 0 first byte marks a free slot
+#define RESULT_STORED 0x80
+
+typedef struct MemoEntry {
+
+    MemoKey key;
+    unsigned char results[MEMO_MAX_RESULTS];
+
+} MemoEntry;
+
+typedef struct MemoShard {
+
+    pthread_mutex_t lock;
+
+    // Open addressing with linear probing, grown past 3/4 full
+    MemoEntry *entries;
+    size_t capacity;
+    size_t count;
+
+    char pad[64];
+
+} MemoShard;
+
+struct Memo {
+
+    unsigned int num_results;
+    MemoShard shards[NUM_SHARDS];
+
+};
+
+static inline uint64_t rotl(uint64_t x, int r) {
+
+    return (x << r) | (x >> (64 - r));
+
+}
+
+// MurmurHash3's 64-bit finalizer
+static inline uint64_t fmix(uint64_t x) {
+
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Two lanes with their own multipliers, as MurmurHash3's x64_128
+static inline void mix(MemoKey *key, uint64_t word) {
+
+    key->hi ^= rotl(word * 0x87c37b91114253d5ULL, 31) * 0x4cf5ad432745937fULL;
+    key->hi = rotl(key->hi, 27) + key->lo;
+    key->hi = key->hi * 5 + 0x52dce729;
+
+    key->lo ^= rotl(word * 0x4cf5ad432745937fULL, 33) * 0x87c37b91114253d5ULL;
+    key->lo = rotl(key->lo, 31) + key->hi;
+    key->lo = key->lo * 5 + 0x38495ab5;
+}
+
+static inline uint64_t bits(double value) {
+
+    uint64_t word;
+    memcpy(&word, &value, sizeof(word));
+    return word;
+}
+
+// Orders by period, deadline and WCET in turn
+static int compare_by_period(const void *a, const void *b) {
+
+    const Task *x = a, *y = b;
+
+    if (x->period != y->period) {
+        return x->period < y->period ? -1 : 1;
+    }
+    if (x->deadline != y->deadline) {
+        return x->deadline < y->deadline ? -1 : 1;
+    }
+    if (x->wcet != y->wcet) {
+        return x->wcet < y->wcet ? -1 : 1;
+    }
+    return 0;
+}
+
+static int compare_by_deadline(const void *a, const void *b) {
+
+    const Task *x = a, *y = b;
+
+    if (x->deadline != y->deadline) {
+        return x->deadline < y->deadline ? -1 : 1;
+    }
+    return compare_by_period(a, b);
+}
+
+static int compare_by_window(const void *a, const void *b) {
+
+    const Task *x = a, *y = b;
+    double u = fmin(x->deadline, x->period), v = fmin(y->deadline, y->period);
+
+    if (u != v) {
+        return u < v ? -1 : 1;
+    }
+    return compare_by_period(a, b);
+}
+
+// 1 if two neighbours of sorted that aren't the same task share key
+static int key_tied(const Task *sorted, unsigned int n, double (*key)(const Task *)) {
+
+    for (unsigned int i = 1; i < n; i++) {
+        if (key(&sorted[i]) == key(&sorted[i - 1]) && compare_by_period(&sorted[i], &sorted[i - 1]) != 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static double period_of(const Task *task) {
+
+    return task->period;
+
+}
+
+static double deadline_of(const Task *task) {
+
+    return task->deadline;
+
+}
+
+static double window_of(const Task *task) {
+
+    return fmin(task->deadline, task->period);
+
+}
+
+int memo_key(TaskSet *task_set, uint64_t variant, Task *sorted, MemoKey *key) {
+
+    unsigned int n = task_set->num_tasks;
+    memcpy(sorted, task_set->tasks, n * sizeof(Task));
+
+    // Ties between tasks that differ leave their priorities to input order
+    qsort(sorted, n, sizeof(Task), compare_by_window);
+    if (key_tied(sorted, n, window_of)) {
+        return 0;
+    }
+    qsort(sorted, n, sizeof(Task), compare_by_deadline);
+    if (key_tied(sorted, n, deadline_of)) {
+        return 0;
+    }
+    qsort(sorted, n, sizeof(Task), compare_by_period);
+    if (key_tied(sorted, n, period_of)) {
+        return 0;
+    }
+
+    MemoKey hash = {0x9e3779b97f4a7c15ULL, 0x6a09e667f3bcc909ULL};
+    mix(&hash, variant);
+    mix(&hash, n);
+
+    for (unsigned int i = 0; i < n; i++) {
+        mix(&hash, bits(sorted[i].wcet));
+        mix(&hash, bits(sorted[i].deadline));
+        mix(&hash, bits(sorted[i].period));
+    }
+
+    hash.hi = fmix(hash.hi + hash.lo);
+    hash.lo = fmix(hash.lo + hash.hi);
+    *key = hash;
+    return 1;
+}
+
+Memo *memo_create(unsigned int num_results) {
+
+    if (num_results > MEMO_MAX_RESULTS) {
+        return NULL;
+    }
+
+    Memo *memo = calloc(1, sizeof(Memo));
+    memo->num_results = num_results;
+
+    for (unsigned int s = 0; s < NUM_SHARDS; s++) {
+        pthread_mutex_init(&memo->shards[s].lock, NULL);
+        memo->shards[s].entries = calloc(INITIAL_CAPACITY, sizeof(MemoEntry));
+        memo->shards[s].capacity = INITIAL_CAPACITY;
+    }
+
+    return memo;
+}
+
+void memo_free(Memo *memo) {
+
+    for (unsigned int s = 0; s < NUM_SHARDS; s++) {
+        pthread_mutex_destroy(&memo->shards[s].lock);
+        free(memo->shards[s].entries);
+    }
+
+    free(memo);
+}
+
+static inline MemoShard *shard_of(Memo *memo, const MemoKey *key) {
+
+    return &memo->shards[key->hi >> (64 - SHARD_BITS)];
+
+}
+
+// The slot holding key, or the free slot it would go in
+static MemoEntry *probe(MemoEntry *entries, size_t capacity, const MemoKey *key) {
+
+    size_t slot = key->lo & (capacity - 1);
+
+    while (entries[slot].results[0] != 0
+           && (entries[slot].key.hi != key->hi || entries[slot].key.lo != key->lo)) {
+        slot = (slot + 1) & (capacity - 1);
+    }
+
+    return &entries[slot];
+}
+
+static void grow(MemoShard *shard) {
+
+    size_t capacity = shard->capacity * 2;
+    MemoEntry *entries = calloc(capacity, sizeof(MemoEntry));
+
+    for (size_t i = 0; i < shard->capacity; i++) {
+        if (shard->entries[i].results[0] != 0) {
+            *probe(entries, capacity, &shard->entries[i].key) = shard->entries[i];
+        }
+    }
+
+    free(shard->entries);
+    shard->entries = entries;
+    shard->capacity = capacity;
+}
+
+int memo_lookup(Memo *memo, const MemoKey *key, analysis_results *results) {
+
+    MemoShard *shard = shard_of(memo, key);
+    unsigned char packed[MEMO_MAX_RESULTS];
+
+    pthread_mutex_lock(&shard->lock);
+    MemoEntry *entry = probe(shard->entries, shard->capacity, key);
+    memcpy(packed, entry->results, sizeof(packed));
+    pthread_mutex_unlock(&shard->lock);
+
+    if (packed[0] == 0) {
+        return 0;
+    }
+
+    for (unsigned int r = 0; r < memo->num_results; r++) {
+        results[r].is_schedulable = packed[r] & 1;
+        results[r].tier = (analysis_tier) ((packed[r] & ~RESULT_STORED) >> 1);
+        results[r].method = METHOD_NONE;
+    }
+
+    return 1;
+}
+
+static void insert_packed(Memo *memo, const MemoKey *key, const unsigned char *packed) {
+
+    MemoShard *shard = shard_of(memo, key);
+
+    pthread_mutex_lock(&shard->lock);
+
+    if ((shard->count + 1) * 4 > shard->capacity * 3) {
+        grow(shard);
+    }
+
+    MemoEntry *entry = probe(shard->entries, shard->capacity, key);
+    if (entry->results[0] == 0) {
+        entry->key = *key;
+        memcpy(entry->results, packed, MEMO_MAX_RESULTS);
+        shard->count++;
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+}
+
+void memo_insert(Memo *memo, const MemoKey *key, const analysis_results *results) {
+
+    unsigned char packed[MEMO_MAX_RESULTS] = {RESULT_STORED};
+
+    for (unsigned int r = 0; r < memo->num_results; r++) {
+        packed[r] = (unsigned char) (RESULT_STORED | (results[r].tier << 1) | (results[r].is_schedulable != 0));
+    }
+
+    insert_packed(memo, key, packed);
+}
+
+size_t memo_size(Memo *memo) {
+
+    size_t count = 0;
+
+    for (unsigned int s = 0; s < NUM_SHARDS; s++) {
+        pthread_mutex_lock(&memo->shards[s].lock);
+        count += memo->shards[s].count;
+        pthread_mutex_unlock(&memo->shards[s].lock);
+    }
+
+    return count;
+}
+
+int memo_load(Memo *memo, const char *path) {
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return errno == ENOENT ? 0 : -1;
+    }
+
+    MemoHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, MEMO_MAGIC, 8) != 0
+        || header.version != MEMO_VERSION || header.num_results != memo->num_results) {
+        fclose(file);
+        errno = EINVAL;
+        return -1;
+    }
+
+    MemoEntry entry;
+    for (uint64_t i = 0; i < header.num_entries; i++) {
+        if (fread(&entry, sizeof(entry), 1, file) != 1 || entry.results[0] == 0) {
+            fclose(file);
+            errno = EINVAL;
+            return -1;
+        }
+        insert_packed(memo, &entry.key, entry.results);
+    }
+
+    fclose(file);
+    return 0;
+}
+
+int memo_save(Memo *memo, const char *path) {
+
+    size_t length = strlen(path);
+    char temporary[length + sizeof(".tmp")];
+    memcpy(temporary, path, length);
+    memcpy(temporary + length, ".tmp", sizeof(".tmp"));
+
+    FILE *file = fopen(temporary, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+
+    MemoHeader header = {MEMO_MAGIC, MEMO_VERSION, memo->num_results, memo_size(memo)};
+    int status = fwrite(&header, sizeof(header), 1, file) == 1 ? 0 : -1;
+
+    for (unsigned int s = 0; s < NUM_SHARDS && status == 0; s++) {
+        MemoShard *shard = &memo->shards[s];
+        for (size_t i = 0; i < shard->capacity && status == 0; i++) {
+            if (shard->entries[i].results[0] != 0 && fwrite(&shard->entries[i], sizeof(MemoEntry), 1, file) != 1) {
+                status = -1;
+            }
+        }
+    }
+
+    if (fclose(file) != 0) {
+        status = -1;
+    }
+
+    if (status == 0 && rename(temporary, path) != 0) {
+        status = -1;
+    }
+
+    if (status != 0) {
+        int saved = errno;
+        remove(temporary);
+        errno = saved;
+    }
+
+    return status;
+}
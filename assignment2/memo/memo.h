@@ -0,0 +1,80 @@
+#ifndef MEMO_H
+#define MEMO_H
+
+#include <stdint.h>
+
+#include "../task_types.h"
+
+/*
+ * Content-addressed memo of analysis results. A set's key is a 128-bit hash
+ * of its tasks sorted by period, deadline and WCET, so the same tasks listed
+ * in any order share it. The analyses do see the input order: it breaks
+ * priority ties and sets the order the utilization, density, bound and
+ * response time sums are taken in, which can round to either side of a
+ * threshold. Sets with priority ties get no key, and callers only insert
+ * results no order of the tasks would change, so a looked up verdict is
+ * always the one the analyses give.
+ *
+ * The memo keeps each result's verdict and tier, not the utilization, which
+ * the caller recomputes so it stays bit for bit what the analyses give.
+ * Lookups and inserts are safe from any number of threads.
+ */
+
+#define MEMO_MAGIC "TASKMEMO"
+#define MEMO_VERSION 3
+
+// Results stored per key
+#define MEMO_MAX_RESULTS 8
+
+typedef struct MemoKey {
+
+    uint64_t hi;
+    uint64_t lo;
+
+} MemoKey;
+
+typedef struct Memo Memo;
+
+// Returns NULL if num_results is over MEMO_MAX_RESULTS
+Memo *memo_create(unsigned int num_results);
+void memo_free(Memo *memo);
+
+/*
+ * variant tells apart results of the same set under different analyses,
+ * e.g. in ticks or not. Critical sections aren't part of the key. sorted
+ * needs room for the set's tasks. Returns 0, with no key, if tasks that
+ * differ share a period, deadline or min(D, P).
+ */
+int memo_key(TaskSet *task_set, uint64_t variant, Task *sorted, MemoKey *key);
+
+// Returns 1 and fills every result's verdict and tier if key is known, with
+// METHOD_NONE as no test ran
+int memo_lookup(Memo *memo, const MemoKey *key, analysis_results *results);
+void memo_insert(Memo *memo, const MemoKey *key, const analysis_results *results);
+
+size_t memo_size(Memo *memo);
+
+/*
+ * On-disk memo, version 3, native byte order:
+ *
+ *     MemoHeader
+ *     { uint64_t hi, lo; uint8_t results[MEMO_MAX_RESULTS]; }   num_entries times
+ *
+ * Loading a file that doesn't exist leaves the memo empty and succeeds; a
+ * file of another version or number of results is rejected with EINVAL.
+ * Saving writes path.tmp and renames it over path, and mustn't race with
+ * inserts. Both return 0 or -1 with errno set.
+ */
+typedef struct MemoHeader {
+
+    char magic[8];
+    uint32_t version;
+    uint32_t num_results;
+    uint64_t num_entries;
+
+} MemoHeader;
+
+int memo_load(Memo *memo, const char *path);
+int memo_save(Memo *memo, const char *path);
+
+#endif //MEMO_H
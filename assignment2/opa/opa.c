@@ -0,0 +1,251 @@
+#include <math.h>
+#include <string.h>
+
+#include "opa.h"
+#include "../rta/rta.h"
+#include "../rta/interference.h"
+
+// Relative margin taken off the C_k / (1 - U_hp) lower bound, so the running
+// utilization's rounding can't push it past the fixed point
+#define START_MARGIN 1e-6
+
+/*
+ * Tasks without a priority level yet, in task set order with one contiguous
+ * array per parameter, so one interference kernel call covers the whole
+ * pool and the terms add up in the order rta_schedulable adds them.
+ * by_deadline lists the pool positions in deadline monotonic order. Tasks
+ * leave by closing the gap, which keeps both orders, and the utilization
+ * total is kept up to date as they do.
+ *
+ * response[] keeps each task's response time from its last trial, INFINITY
+ * if it had none. Tasks only ever leave, so a later trial sees less
+ * interference and the old value bounds the new one from above.
+ */
+typedef struct Pool {
+
+    unsigned int count;
+    unsigned int *task;
+    unsigned int *by_deadline;
+    double *wcet;
+    double *period;
+    double *deadline;
+    double *inv_period;
+    double *response;
+
+    double utilization;
+
+} Pool;
+
+// Takes the task at pool position k out, r is its place in by_deadline
+static void pool_remove(Pool *pool, unsigned int k, unsigned int r) {
+
+    pool->utilization -= pool->wcet[k] * pool->inv_period[k];
+
+    unsigned int tail = pool->count - k - 1;
+    memmove(pool->task + k, pool->task + k + 1, tail * sizeof(unsigned int));
+    memmove(pool->wcet + k, pool->wcet + k + 1, tail * sizeof(double));
+    memmove(pool->period + k, pool->period + k + 1, tail * sizeof(double));
+    memmove(pool->deadline + k, pool->deadline + k + 1, tail * sizeof(double));
+    memmove(pool->inv_period + k, pool->inv_period + k + 1, tail * sizeof(double));
+    memmove(pool->response + k, pool->response + k + 1, tail * sizeof(double));
+
+    pool->count--;
+    memmove(pool->by_deadline + r, pool->by_deadline + r + 1, (pool->count - r) * sizeof(unsigned int));
+    for (unsigned int i = 0; i < pool->count; i++) {
+        pool->by_deadline[i] -= pool->by_deadline[i] > k;
+    }
+}
+
+// Task k's WCET plus the interference of every other pool task in a window of length t
+static double pool_demand(Pool *pool, unsigned int k, double t, interference_fn interference, double *terms) {
+
+    double demand = pool->wcet[k];
+
+    // Task k's own term is made along with the rest and skipped
+    interference(t, pool->wcet, pool->period, pool->inv_period, pool->count, terms);
+    for (unsigned int j = 0; j < k; j++) {
+        demand += terms[j];
+    }
+    for (unsigned int j = k + 1; j < pool->count; j++) {
+        demand += terms[j];
+    }
+
+    return demand;
+}
+
+/*
+ * Task k's WCET plus one job of every other pool task, added up as
+ * pool_demand adds them in a window shorter than every period
+ */
+static double pool_work(Pool *pool, unsigned int k) {
+
+    double work = pool->wcet[k];
+    for (unsigned int j = 0; j < k; j++) {
+        work += pool->wcet[j];
+    }
+    for (unsigned int j = k + 1; j < pool->count; j++) {
+        work += pool->wcet[j];
+    }
+
+    return work;
+}
+
+/*
+ * Returns 1 if task k of the pool meets its deadline with every other pool
+ * task at a higher priority. Same recurrence as rta_schedulable, started
+ * from two lower bounds of the response time R instead of 0: the work of
+ * one job of every task, and C_k / (1 - U_hp), as R >= C_k + R * U_hp.
+ * Both only hold for C_k > 0, which is why tasks without work stay out of
+ * the pool. The second bound is only used through one step of the
+ * recurrence, so that like the first and like every iterate from 0 the
+ * start is a sum of whole jobs, and can't sit just below a step of the
+ * recurrence and pass for converged.
+ *
+ * A task retried after failing at a lower level first resumes from its
+ * last response time R_old. When the demand d in a window of R_old is at
+ * most R_old, the recurrence from 0 can't pass d, so R <= d and a d within
+ * the deadline settles it without iterating. Otherwise the recurrence runs
+ * as above.
+ */
+static int fits_lowest(Pool *pool, unsigned int k, interference_fn interference, double *terms) {
+
+    double wcet = pool->wcet[k];
+
+    if (pool->response[k] <= pool->period[k]) {
+        double demand = pool_demand(pool, k, pool->response[k], interference, terms);
+        if (demand <= pool->response[k]) {
+            pool->response[k] = demand;
+            if (demand <= pool->deadline[k]) {
+                return 1;
+            }
+        }
+    }
+
+    double hp_utilization = pool->utilization - wcet * pool->inv_period[k];
+
+    double a_n, a_n1 = pool_work(pool, k);
+    if (hp_utilization < 1.0) {
+        double bound = wcet / (1.0 - hp_utilization) * (1.0 - START_MARGIN);
+        if (bound > a_n1) {
+            a_n1 = pool_demand(pool, k, bound, interference, terms);
+        }
+    }
+
+    for (;;) {
+
+        a_n = a_n1;
+        a_n1 = pool_demand(pool, k, a_n, interference, terms);
+
+        // Checked first, as the start may already be past the period, where
+        // rta_schedulable would have given up on the way
+        if (a_n1 > pool->period[k]) {
+            pool->response[k] = INFINITY;
+            return 0;
+        }
+
+        if (fabs(a_n1 - a_n) < 0.0001) {
+            pool->response[k] = a_n1;
+            return a_n1 <= pool->deadline[k];
+        }
+    }
+}
+
+static int assign(TaskSet *task_set, unsigned int *order) {
+
+    unsigned int n = task_set->num_tasks, top = 0;
+    unsigned int task[n + 1], by_deadline[n + 1], dm[n + 1], position[n + 1];
+    double storage[5 * n + 1], terms[n + 1];
+
+    Pool pool = {0, task, by_deadline, storage, storage + n, storage + 2 * n, storage + 3 * n,
+                 storage + 4 * n, 0.0};
+
+    for (unsigned int i = 0; i < n; i++) {
+        Task *t = &task_set->tasks[i];
+        if (t->wcet == 0.0) {
+            continue;
+        }
+
+        unsigned int k = pool.count++;
+        position[i] = k;
+        pool.task[k] = i;
+        pool.wcet[k] = t->wcet;
+        pool.period[k] = t->period;
+        pool.deadline[k] = t->deadline;
+        pool.inv_period[k] = 1.0 / t->period;
+        pool.response[k] = INFINITY;
+        pool.utilization += t->wcet * pool.inv_period[k];
+    }
+
+    /*
+     * A task without work is done as soon as it's released and delays no
+     * other task, so it meets its deadline at any level. Those take the
+     * highest levels in deadline order and never enter the pool, where they
+     * would take the lowest levels and have every task that doesn't fit
+     * tried again at each of them.
+     */
+    priority_order(dm, task_set, PRIORITY_BY_DEADLINE);
+    for (unsigned int i = 0, r = 0; i < n; i++) {
+        Task *t = &task_set->tasks[dm[i]];
+        if (t->wcet != 0.0) {
+            pool.by_deadline[r++] = position[dm[i]];
+        } else if (t->deadline >= 0.0) {
+            order[top++] = dm[i];
+        } else {
+            return 0;
+        }
+    }
+
+    interference_fn interference = interference_kernel();
+
+    for (unsigned int level = n; level-- > top;) {
+
+        /*
+         * Longest deadline first: when the deadline monotonic order works
+         * the first candidate at every level fits, and the search costs
+         * one response time per task like plain RTA.
+         */
+        unsigned int r = pool.count, k = 0;
+        int fits = 0;
+        while (r > 0 && !fits) {
+            r--;
+            k = pool.by_deadline[r];
+            fits = fits_lowest(&pool, k, interference, terms);
+        }
+
+        // Nothing fits at this level, and a different choice at a lower
+        // level would only have left more interference for this one
+        if (!fits) {
+            return 0;
+        }
+
+        order[level] = pool.task[k];
+        pool_remove(&pool, k, r);
+    }
+
+    return 1;
+}
+
+analysis_results opa_assign(TaskSet *task_set, unsigned int *order) {
+
+    analysis_results ret = {0, 0, TIER_UTILIZATION};
+
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        ret.utilization += task_set->tasks[i].wcet / task_set->tasks[i].period;
+    }
+
+    // Processor is overloaded, no priority order can work
+    if (ret.utilization > 1.0) {
+        return ret;
+    }
+
+    ret.tier = TIER_EXACT;
+    ret.is_schedulable = assign(task_set, order);
+    return ret;
+}
+
+analysis_results opa_analysis(TaskSet *task_set) {
+
+    unsigned int order[task_set->num_tasks + 1];
+    return opa_assign(task_set, order);
+
+}
@@ -0,0 +1,20 @@
+#ifndef OPA_H
+#define OPA_H
+
+#include "../task_types.h"
+
+/*
+ * Audsley's optimal priority assignment. Fills the lowest priority level
+ * first with any task that meets its deadline below all the others still
+ * unassigned, which finds a fixed priority order passing response-time
+ * analysis whenever one exists, not only the RM or DM one.
+ *
+ * For a schedulable set order[] holds task_set's task indices from highest
+ * to lowest priority. order needs num_tasks entries.
+ */
+analysis_results opa_assign(TaskSet *task_set, unsigned int *order);
+
+// opa_assign as an analysis_fn, for when only the verdict is wanted
+analysis_results opa_analysis(TaskSet *task_set);
+
+#endif //OPA_H
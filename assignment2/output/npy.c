@@ -0,0 +1,77 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "npy.h"
+
+// Magic, version, header length and the padded header dictionary. Fixed, so
+// the header can be rewritten in place once the count is known
+#define HEADER_SIZE 128
+#define PREAMBLE_SIZE 10
+
+// Buffer size for the underlying stdio stream
+#define WRITE_BUFFER (1 << 20)
+
+static int write_header(NpyFile *npy) {
+
+    char header[HEADER_SIZE];
+    uint16_t length = HEADER_SIZE - PREAMBLE_SIZE;
+
+    memcpy(header, "\x93NUMPY\x01\x00", 8);
+    header[8] = (char) (length & 0xff);
+    header[9] = (char) (length >> 8);
+
+    // Padded with spaces up to a newline at the end, as numpy does
+    char *dict = header + PREAMBLE_SIZE;
+    int used = snprintf(dict, length, "{'descr': '%s', 'fortran_order': False, 'shape': (%zu,), }",
+                        npy->descr, npy->count);
+    if (used < 0 || used >= length) {
+        return -1;
+    }
+    memset(dict + used, ' ', length - used - 1);
+    dict[length - 1] = '\n';
+
+    return fwrite(header, HEADER_SIZE, 1, npy->file) == 1 ? 0 : -1;
+}
+
+int npy_open(NpyFile *npy, const char *path, const char *descr, size_t item_size) {
+
+    npy->descr = descr;
+    npy->item_size = item_size;
+    npy->count = 0;
+
+    npy->file = fopen(path, "wb");
+    if (npy->file == NULL) {
+        return -1;
+    }
+
+    setvbuf(npy->file, NULL, _IOFBF, WRITE_BUFFER);
+
+    if (write_header(npy) != 0) {
+        fclose(npy->file);
+        return -1;
+    }
+
+    return 0;
+}
+
+int npy_append(NpyFile *npy, const void *items, size_t count) {
+
+    if (fwrite(items, npy->item_size, count, npy->file) != count) {
+        return -1;
+    }
+
+    npy->count += count;
+    return 0;
+}
+
+int npy_close(NpyFile *npy) {
+
+    int status = fseek(npy->file, 0, SEEK_SET) == 0 && write_header(npy) == 0 ? 0 : -1;
+
+    if (fclose(npy->file) != 0) {
+        status = -1;
+    }
+
+    npy->file = NULL;
+    return status;
+}
@@ -0,0 +1,36 @@
+#ifndef NPY_H
+#define NPY_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * Writer for one-dimensional NumPy .npy files (format version 1.0), which
+ * numpy.load(..., mmap_mode="r") maps without parsing. Values are appended
+ * in any number of pieces and the element count in the header is filled in
+ * by npy_close, so the length doesn't need to be known up front.
+ */
+
+// dtype strings for the types written here
+#define NPY_UINT8   "|u1"
+#define NPY_FLOAT64 "<f8"
+
+typedef struct NpyFile {
+
+    FILE *file;
+    const char *descr;
+    size_t item_size;
+    size_t count;
+
+} NpyFile;
+
+// Creates path with a placeholder header. Returns 0, or -1 with errno set
+int npy_open(NpyFile *npy, const char *path, const char *descr, size_t item_size);
+
+// Appends count items of the file's item size. Returns 0 or -1
+int npy_append(NpyFile *npy, const void *items, size_t count);
+
+// Writes the final header and closes the file. Returns 0 or -1
+int npy_close(NpyFile *npy);
+
+#endif //NPY_H
@@ -0,0 +1,157 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "parallel.h"
+
+/*
+ * Each worker owns a slice [begin, end) of the item range. The owner takes
+ * from the front, thieves take from the back, both under the slice's lock.
+ * Slices only ever shrink or get refilled by their owner, so once a worker
+ * has found every slice empty there is no work left anywhere.
+ */
+typedef struct Slice {
+
+    pthread_mutex_t lock;
+    size_t begin;
+    size_t end;
+
+    // Keep neighbouring slices off the same cache line
+    char pad[64];
+
+} Slice;
+
+typedef struct Pool {
+
+    unsigned num_workers;
+    size_t grain;
+    parallel_body body;
+    void *ctx;
+    Slice *slices;
+
+} Pool;
+
+typedef struct Worker {
+
+    Pool *pool;
+    unsigned id;
+
+} Worker;
+
+unsigned parallel_num_cpus(void) {
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus < 1 ? 1 : (unsigned) cpus;
+
+}
+
+// Take up to grain items from the front of our own slice
+static int take_own(Pool *pool, Slice *slice, size_t *begin, size_t *end) {
+
+    int found = 0;
+
+    pthread_mutex_lock(&slice->lock);
+    if (slice->begin < slice->end) {
+        *begin = slice->begin;
+        *end = slice->end - slice->begin > pool->grain ? slice->begin + pool->grain : slice->end;
+        slice->begin = *end;
+        found = 1;
+    }
+    pthread_mutex_unlock(&slice->lock);
+
+    return found;
+}
+
+// Move the back half of some other worker's slice into our own
+static int steal(Pool *pool, unsigned thief) {
+
+    for (unsigned k = 1; k < pool->num_workers; k++) {
+
+        Slice *victim = &pool->slices[(thief + k) % pool->num_workers];
+        size_t begin = 0, end = 0;
+
+        pthread_mutex_lock(&victim->lock);
+        if (victim->begin < victim->end) {
+            size_t remaining = victim->end - victim->begin;
+            begin = victim->end - (remaining + 1) / 2;
+            end = victim->end;
+            victim->end = begin;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (begin < end) {
+            Slice *own = &pool->slices[thief];
+            pthread_mutex_lock(&own->lock);
+            own->begin = begin;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void *worker_main(void *arg) {
+
+    Worker *worker = arg;
+    Pool *pool = worker->pool;
+    Slice *own = &pool->slices[worker->id];
+
+    for (;;) {
+
+        size_t begin, end;
+
+        while (take_own(pool, own, &begin, &end)) {
+            pool->body(begin, end, worker->id, pool->ctx);
+        }
+
+        if (!steal(pool, worker->id)) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+void parallel_for(unsigned num_workers, size_t count, size_t grain,
+                  parallel_body body, void *ctx) {
+
+    if (count == 0) {
+        return;
+    }
+
+    if (grain == 0) {
+        grain = 1;
+    }
+
+    if (num_workers <= 1) {
+        body(0, count, 0, ctx);
+        return;
+    }
+
+    Pool pool = {num_workers, grain, body, ctx, calloc(num_workers, sizeof(Slice))};
+    Worker workers[num_workers];
+    pthread_t threads[num_workers];
+
+    for (unsigned i = 0; i < num_workers; i++) {
+        pthread_mutex_init(&pool.slices[i].lock, NULL);
+        pool.slices[i].begin = count * i / num_workers;
+        pool.slices[i].end = count * (i + 1) / num_workers;
+        workers[i] = (Worker) {&pool, i};
+    }
+
+    // Worker 0 runs on the calling thread
+    for (unsigned i = 1; i < num_workers; i++) {
+        pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+    }
+    worker_main(&workers[0]);
+    for (unsigned i = 1; i < num_workers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (unsigned i = 0; i < num_workers; i++) {
+        pthread_mutex_destroy(&pool.slices[i].lock);
+    }
+    free(pool.slices);
+}
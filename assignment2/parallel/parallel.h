@@ -0,0 +1,27 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+/*
+ * Body of a parallel loop. Called with a half-open range [begin, end) of
+ * item indices and the index of the worker running it, so per-worker state
+ * (counters, scratch buffers) can be kept without locking.
+ */
+typedef void (*parallel_body)(size_t begin, size_t end, unsigned worker, void *ctx);
+
+// Number of online processors, at least 1
+unsigned parallel_num_cpus(void);
+
+/*
+ * Runs body over [0, count) on num_workers threads. Every worker starts with
+ * an equal slice of the range and takes grain items at a time from the front
+ * of it. A worker whose slice runs dry steals the back half of another
+ * worker's remaining slice, so uneven per-item costs still balance out.
+ *
+ * With a single worker the body runs on the calling thread.
+ */
+void parallel_for(unsigned num_workers, size_t count, size_t grain,
+                  parallel_body body, void *ctx);
+
+#endif //PARALLEL_H
@@ -0,0 +1,297 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "partition.h"
+#include "../edf/edf.h"
+#include "../rta/rta.h"
+
+/*
+ * Tasks placed on one core so far, with what adding another needs kept up
+ * to date so a trial only redoes the work the new task can change.
+ */
+struct Core {
+
+    unsigned int count;
+    double utilization;
+    double density;
+
+    // EDF: the tasks in the order they were placed, one spare slot at the end
+    Task *tasks;
+
+    // RM and DM: the tasks in priority order, their indices in the task set
+    // to break ties the way priority_set_build does and as set.input, and
+    // their response times, which are lower bounds for the same tasks once
+    // more are added
+    PrioritySet set;
+    unsigned int *index;
+    double *response;
+
+    // ∏ (C_i / min(D_i, P_i) + 1), and whether min(D_i, P_i) still rises
+    // with the priority order, for the hyperbolic bound of rta_bound_schedulable
+    double product;
+    int windows_sorted;
+
+};
+
+/*
+ * Utilization and density are summed as tasks are placed, so only a core
+ * neither bound decides needs the demand test, which then runs over the
+ * placed tasks in place with the candidate in the spare slot.
+ */
+static int edf_fits(Core *core, Task *task) {
+
+    double utilization = task->wcet / task->period;
+    double density = task->wcet > 0 ? task->wcet / fmin(task->deadline, task->period) : 0.0;
+
+    if (core->utilization + utilization > 1.0) {
+        return 0;
+    }
+
+    core->tasks[core->count] = *task;
+
+    if (core->density + density > 1.0) {
+        TaskSet trial = {core->count + 1, core->tasks, NULL};
+        if (!edf_analysis(&trial).is_schedulable) {
+            return 0;
+        }
+    }
+
+    core->count++;
+    core->utilization += utilization;
+    core->density += density;
+    return 1;
+}
+
+static void shift(PrioritySet *set, unsigned int *index, double *response, unsigned int from,
+                  unsigned int to, unsigned int count) {
+
+    memmove(set->wcet + to, set->wcet + from, count * sizeof(double));
+    memmove(set->period + to, set->period + from, count * sizeof(double));
+    memmove(set->deadline + to, set->deadline + from, count * sizeof(double));
+    memmove(set->inv_period + to, set->inv_period + from, count * sizeof(double));
+    memmove(index + to, index + from, count * sizeof(unsigned int));
+    memmove(response + to, response + from, count * sizeof(double));
+}
+
+/*
+ * The task goes in at its priority. Tasks above it are unaffected, and
+ * those below only gain interference, so their response times so far are
+ * where their recurrences restart. saved holds those response times in
+ * case the task doesn't fit after all.
+ */
+static int fixed_priority_fits(Core *core, Task *task, unsigned int index, PriorityOrder order,
+                               double *saved) {
+
+    double utilization = task->wcet / task->period;
+    if (core->utilization + utilization > 1.0) {
+        return 0;
+    }
+
+    PrioritySet *set = &core->set;
+    const double *keys = order == PRIORITY_BY_PERIOD ? set->period : set->deadline;
+    double key = order == PRIORITY_BY_PERIOD ? task->period : task->deadline;
+
+    unsigned int p = 0;
+    while (p < core->count && (keys[p] < key || (keys[p] == key && core->index[p] < index))) {
+        p++;
+    }
+
+    unsigned int below = core->count - p;
+    memcpy(saved, core->response + p, below * sizeof(double));
+    shift(set, core->index, core->response, p, p + 1, below);
+
+    set->wcet[p] = task->wcet;
+    set->period[p] = task->period;
+    set->deadline[p] = task->deadline;
+    set->inv_period[p] = 1.0 / task->period;
+    core->index[p] = index;
+    core->response[p] = 0.0;
+    set->num_tasks = core->count + 1;
+
+    // Once out of order the windows stay that way, tasks are only ever added
+    double window = fmin(task->deadline, task->period);
+    int windows_sorted = core->windows_sorted
+                         && (p == 0 || fmin(set->deadline[p - 1], set->period[p - 1]) <= window)
+                         && (below == 0 || window <= fmin(set->deadline[p + 1], set->period[p + 1]));
+    double product = core->product * (task->wcet / window + 1.0);
+
+    // The bound needs no response times, and the ones kept stay lower bounds
+    int bounded = windows_sorted && product <= 2.0 - RTA_BOUND_MARGIN;
+
+    if (!bounded && !rta_schedulable_from(set, p, core->response)) {
+        shift(set, core->index, core->response, p + 1, p, below);
+        memcpy(core->response + p, saved, below * sizeof(double));
+        set->num_tasks = core->count;
+        return 0;
+    }
+
+    core->count++;
+    core->utilization += utilization;
+    core->product = product;
+    core->windows_sorted = windows_sorted;
+    return 1;
+}
+
+static int fits(Core *core, TaskSet *task_set, unsigned int index, PartitionTest test,
+                double *saved) {
+
+    Task *task = &task_set->tasks[index];
+
+    switch (test) {
+        case PARTITION_RM:
+            return fixed_priority_fits(core, task, index, PRIORITY_BY_PERIOD, saved);
+        case PARTITION_DM:
+            return fixed_priority_fits(core, task, index, PRIORITY_BY_DEADLINE, saved);
+        default:
+            return edf_fits(core, task);
+    }
+}
+
+// Stable insertion sort of index by key[index[i]]
+static void sort_by(unsigned int *index, double *key, unsigned int n, int descending) {
+
+    for (unsigned int i = 1; i < n; i++) {
+        unsigned int moving = index[i];
+        double moving_key = key[moving];
+        unsigned int k = i;
+        while (k > 0 && (descending ? key[index[k - 1]] < moving_key : key[index[k - 1]] > moving_key)) {
+            index[k] = index[k - 1];
+            k--;
+        }
+        index[k] = moving;
+    }
+}
+
+// Whether core a comes before core b in the order the heuristic tries them, ties to the lowest numbered
+static int precedes(Core *cores, unsigned int a, unsigned int b, PartitionHeuristic heuristic) {
+
+    double load_a = cores[a].utilization, load_b = cores[b].utilization;
+    if (heuristic == FIRST_FIT_DECREASING || load_a == load_b) {
+        return a < b;
+    }
+    return heuristic == BEST_FIT_DECREASING ? load_a > load_b : load_a < load_b;
+}
+
+/*
+ * Moves candidates[k] to its place after its core took a task. Only that
+ * core's load went up, so the rest stay in order and it only ever moves
+ * forward under best fit and back under worst fit.
+ */
+static void reposition(unsigned int *candidates, unsigned int num_cores, unsigned int k, Core *cores,
+                       PartitionHeuristic heuristic) {
+
+    unsigned int moving = candidates[k];
+
+    if (heuristic == BEST_FIT_DECREASING) {
+        // First of candidates[0..k-1] it now goes before
+        unsigned int low = 0, high = k;
+        while (low < high) {
+            unsigned int mid = low + (high - low) / 2;
+            if (precedes(cores, moving, candidates[mid], heuristic)) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        memmove(candidates + low + 1, candidates + low, (k - low) * sizeof(unsigned int));
+        candidates[low] = moving;
+    } else if (heuristic == WORST_FIT_DECREASING) {
+        // First of candidates[k+1..] it still goes before
+        unsigned int low = k + 1, high = num_cores;
+        while (low < high) {
+            unsigned int mid = low + (high - low) / 2;
+            if (precedes(cores, candidates[mid], moving, heuristic)) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        memmove(candidates + k, candidates + k + 1, (low - 1 - k) * sizeof(unsigned int));
+        candidates[low - 1] = moving;
+    }
+}
+
+int partition_scratch_init(PartitionScratch *scratch, unsigned int num_cores, unsigned int max_tasks) {
+
+    size_t cores = num_cores, n = max_tasks;
+
+    *scratch = (PartitionScratch) {num_cores, max_tasks};
+    scratch->cores = malloc(cores * sizeof(Core));
+    scratch->tasks = malloc(cores * (n + 1) * sizeof(Task));
+    scratch->storage = malloc((cores * 5 * n + 1) * sizeof(double));
+    scratch->indices = malloc((cores * n + 1) * sizeof(unsigned int));
+    scratch->order = malloc((n + 1) * sizeof(unsigned int));
+    scratch->utilization = malloc((n + 1) * sizeof(double));
+    scratch->saved = malloc((n + 1) * sizeof(double));
+    scratch->candidates = malloc(cores * sizeof(unsigned int));
+
+    if (scratch->cores == NULL || scratch->tasks == NULL || scratch->storage == NULL
+        || scratch->indices == NULL || scratch->order == NULL || scratch->utilization == NULL
+        || scratch->saved == NULL || scratch->candidates == NULL) {
+        partition_scratch_free(scratch);
+        return -1;
+    }
+
+    return 0;
+}
+
+void partition_scratch_free(PartitionScratch *scratch) {
+
+    free(scratch->cores);
+    free(scratch->tasks);
+    free(scratch->storage);
+    free(scratch->indices);
+    free(scratch->order);
+    free(scratch->utilization);
+    free(scratch->saved);
+    free(scratch->candidates);
+    *scratch = (PartitionScratch) {0};
+}
+
+int partition_schedulable(TaskSet *task_set, PartitionScratch *scratch, PartitionHeuristic heuristic,
+                          PartitionTest test) {
+
+    unsigned int n = task_set->num_tasks;
+    unsigned int num_cores = scratch->num_cores;
+    Core *cores = scratch->cores;
+    double *saved = scratch->saved;
+
+    // Every core has room for all n tasks plus EDF's spare slot
+    for (unsigned int c = 0; c < num_cores; c++) {
+        double *s = scratch->storage + (size_t) c * 5 * n;
+        cores[c] = (Core) {0, 0.0, 0.0, scratch->tasks + (size_t) c * (n + 1),
+                           {0, s, s + n, s + 2 * n, s + 3 * n, NULL, scratch->indices + (size_t) c * n},
+                           scratch->indices + (size_t) c * n, s + 4 * n,
+                           1.0, 1};
+    }
+
+    unsigned int *order = scratch->order;
+    double *utilization = scratch->utilization;
+    for (unsigned int i = 0; i < n; i++) {
+        order[i] = i;
+        utilization[i] = task_set->tasks[i].wcet / task_set->tasks[i].period;
+    }
+    sort_by(order, utilization, n, 1);
+
+    // Cores in the order the heuristic prefers them, all empty to start with
+    unsigned int *candidates = scratch->candidates;
+    for (unsigned int c = 0; c < num_cores; c++) {
+        candidates[c] = c;
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+
+        unsigned int c = 0;
+        while (c < num_cores && !fits(&cores[candidates[c]], task_set, order[i], test, saved)) {
+            c++;
+        }
+
+        if (c == num_cores) {
+            return 0;
+        }
+        reposition(candidates, num_cores, c, cores, heuristic);
+    }
+
+    return 1;
+}
@@ -0,0 +1,72 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "../task_types.h"
+
+/*
+ * Partitioned scheduling on identical cores: every task is placed on one
+ * core for good and each core is scheduled on its own. Tasks are placed in
+ * order of decreasing utilization, each on a core chosen by the heuristic
+ * among those that still pass the exact uniprocessor test with it added.
+ */
+
+typedef enum PartitionHeuristic {
+
+    FIRST_FIT_DECREASING,   // Lowest numbered core
+    BEST_FIT_DECREASING,    // Most loaded core
+    WORST_FIT_DECREASING,   // Least loaded core
+
+} PartitionHeuristic;
+
+typedef enum PartitionTest {
+
+    PARTITION_EDF,
+    PARTITION_RM,
+    PARTITION_DM,
+
+} PartitionTest;
+
+// Most cores a set can be partitioned onto
+#define PARTITION_MAX_CORES 4096
+
+typedef struct Core Core;
+
+/*
+ * Working memory of partition_schedulable for sets of up to max_tasks tasks
+ * on num_cores cores. It grows with both, so it lives on the heap, set up
+ * once per thread and reused for every set.
+ */
+typedef struct PartitionScratch {
+
+    unsigned int num_cores;
+    unsigned int max_tasks;
+
+    Core *cores;
+
+    // Per core: max_tasks + 1 tasks, 5 * max_tasks doubles and max_tasks indices
+    Task *tasks;
+    double *storage;
+    unsigned int *indices;
+
+    // Per set: placement order, utilizations and saved response times
+    unsigned int *order;
+    double *utilization;
+    double *saved;
+
+    // Per set: the cores in the heuristic's order, kept sorted as they fill
+    unsigned int *candidates;
+
+} PartitionScratch;
+
+// Returns 0, or -1 if out of memory, in which case nothing needs freeing
+int partition_scratch_init(PartitionScratch *scratch, unsigned int num_cores, unsigned int max_tasks);
+void partition_scratch_free(PartitionScratch *scratch);
+
+/*
+ * Returns 1 if the heuristic finds a placement onto scratch's cores where
+ * every core passes the test. task_set has at most scratch->max_tasks tasks.
+ */
+int partition_schedulable(TaskSet *task_set, PartitionScratch *scratch, PartitionHeuristic heuristic,
+                          PartitionTest test);
+
+#endif //PARTITION_H
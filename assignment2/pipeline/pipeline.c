@@ -0,0 +1,139 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "pipeline.h"
+#include "queue.h"
+
+typedef struct Pipeline {
+
+    PipelineStages *stages;
+
+    Queue free;
+    Queue ready;
+    Queue done;
+
+    // Analyzers still running, the last one out closes the done queue
+    unsigned analyzers_left;
+    pthread_mutex_t lock;
+
+} Pipeline;
+
+typedef struct Analyzer {
+
+    Pipeline *pipeline;
+    unsigned id;
+
+} Analyzer;
+
+static void *reader_main(void *arg) {
+
+    Pipeline *pipeline = arg;
+    size_t seq = 0;
+
+    for (;;) {
+
+        PipelineSlot *slot = queue_pop(&pipeline->free);
+
+        if (!pipeline->stages->read(slot, pipeline->stages->ctx)) {
+            queue_push(&pipeline->free, slot);
+            break;
+        }
+
+        slot->seq = seq++;
+        queue_push(&pipeline->ready, slot);
+    }
+
+    queue_close(&pipeline->ready);
+    return NULL;
+}
+
+static void *analyzer_main(void *arg) {
+
+    Analyzer *analyzer = arg;
+    Pipeline *pipeline = analyzer->pipeline;
+    PipelineSlot *slot;
+
+    while ((slot = queue_pop(&pipeline->ready)) != NULL) {
+        pipeline->stages->analyze(slot, analyzer->id, pipeline->stages->ctx);
+        queue_push(&pipeline->done, slot);
+    }
+
+    pthread_mutex_lock(&pipeline->lock);
+    if (--pipeline->analyzers_left == 0) {
+        queue_close(&pipeline->done);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+
+    return NULL;
+}
+
+void pipeline_run(unsigned num_slots, unsigned num_analyzers, unsigned num_results,
+                  PipelineStages *stages) {
+
+    if (num_analyzers == 0) {
+        num_analyzers = 1;
+    }
+
+    Pipeline pipeline = {stages};
+    PipelineSlot *slots = calloc(num_slots, sizeof(PipelineSlot));
+
+    // Slots that arrive at the writer early wait here until their turn. Every
+    // slot in flight has a seq within num_slots of the next one to write, so
+    // seq % num_slots never collides.
+    PipelineSlot **pending = calloc(num_slots, sizeof(PipelineSlot *));
+
+    queue_init(&pipeline.free, num_slots);
+    queue_init(&pipeline.ready, num_slots);
+    queue_init(&pipeline.done, num_slots);
+    pipeline.analyzers_left = num_analyzers;
+    pthread_mutex_init(&pipeline.lock, NULL);
+
+    for (unsigned i = 0; i < num_slots; i++) {
+        slots[i].results = calloc(num_results, sizeof(analysis_results));
+        arena_init(&slots[i].arena, PIPELINE_CHUNK_SIZE);
+        queue_push(&pipeline.free, &slots[i]);
+    }
+
+    pthread_t reader;
+    pthread_t analyzer_threads[num_analyzers];
+    Analyzer analyzers[num_analyzers];
+
+    pthread_create(&reader, NULL, reader_main, &pipeline);
+    for (unsigned i = 0; i < num_analyzers; i++) {
+        analyzers[i] = (Analyzer) {&pipeline, i};
+        pthread_create(&analyzer_threads[i], NULL, analyzer_main, &analyzers[i]);
+    }
+
+    // Writer
+    size_t next_seq = 0;
+    PipelineSlot *slot;
+
+    while ((slot = queue_pop(&pipeline.done)) != NULL) {
+
+        pending[slot->seq % num_slots] = slot;
+
+        while ((slot = pending[next_seq % num_slots]) != NULL && slot->seq == next_seq) {
+            pending[next_seq % num_slots] = NULL;
+            stages->write(slot, stages->ctx);
+            queue_push(&pipeline.free, slot);
+            next_seq++;
+        }
+    }
+
+    pthread_join(reader, NULL);
+    for (unsigned i = 0; i < num_analyzers; i++) {
+        pthread_join(analyzer_threads[i], NULL);
+    }
+
+    for (unsigned i = 0; i < num_slots; i++) {
+        free(slots[i].results);
+        arena_free(&slots[i].arena);
+    }
+
+    pthread_mutex_destroy(&pipeline.lock);
+    queue_destroy(&pipeline.done);
+    queue_destroy(&pipeline.ready);
+    queue_destroy(&pipeline.free);
+    free(pending);
+    free(slots);
+}
@@ -0,0 +1,52 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stddef.h>
+
+#include "../task_types.h"
+#include "../arena/arena.h"
+
+// Chunk size of each slot's arena
+#define PIPELINE_CHUNK_SIZE (1 << 12)
+
+/*
+ * A task set in flight through the pipeline. Slots are recycled once the
+ * writer is done with them, so the number of slots bounds memory use no
+ * matter how long the input is. The reader resets the slot's arena and
+ * carves the next set out of it.
+ */
+typedef struct PipelineSlot {
+
+    size_t seq;
+    TaskSet task_set;
+    Arena arena;
+    analysis_results *results;
+
+} PipelineSlot;
+
+typedef struct PipelineStages {
+
+    // Fills slot->task_set with the next task set, returns 0 at end of input
+    int (*read)(PipelineSlot *slot, void *ctx);
+
+    // Fills slot->results, may run on several threads at once
+    void (*analyze)(PipelineSlot *slot, unsigned worker, void *ctx);
+
+    // Consumes slot->results, called in input order
+    void (*write)(PipelineSlot *slot, void *ctx);
+
+    void *ctx;
+
+} PipelineStages;
+
+/*
+ * Runs reader -> analyzers -> writer until read reports end of input.
+ *
+ * The reader runs on its own thread, num_analyzers threads analyze, and the
+ * writer runs on the calling thread. Stages are connected by bounded queues
+ * and at most num_slots task sets are held at any time.
+ */
+void pipeline_run(unsigned num_slots, unsigned num_analyzers, unsigned num_results,
+                  PipelineStages *stages);
+
+#endif //PIPELINE_H
@@ -0,0 +1,36 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <pthread.h>
+
+/*
+ * Bounded blocking FIFO of pointers. Pushing to a full queue blocks until a
+ * consumer makes room, popping from an empty queue blocks until a producer
+ * pushes or the queue is closed.
+ */
+typedef struct Queue {
+
+    void **items;
+    unsigned int capacity;
+    unsigned int head;
+    unsigned int count;
+    int closed;
+
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+
+} Queue;
+
+void queue_init(Queue *queue, unsigned int capacity);
+void queue_destroy(Queue *queue);
+
+void queue_push(Queue *queue, void *item);
+
+// Returns NULL once the queue is closed and drained
+void *queue_pop(Queue *queue);
+
+// Wakes every consumer; pops keep returning items until the queue is empty
+void queue_close(Queue *queue);
+
+#endif //QUEUE_H
@@ -1,6 +1,8 @@
 #include <math.h>
 #include <stdio.h>
 #include "../task_types.h"
+#include "../rta/rta.h"
+#include "../rta/blocking.h"
 
 analysis_results rm_analysis(TaskSet *task_set) {
 
@@ -73,7 +75,7 @@ analysis_results rm_analysis(TaskSet *task_set) {
      *
      */
 
-    analysis_results ret = {0, 0};
+    analysis_results ret = {0, 0, TIER_UTILIZATION};
 
     // Utilization
     // Doing in separate loop in case the other one returns early
@@ -83,55 +85,65 @@ analysis_results rm_analysis(TaskSet *task_set) {
 
     }
 
-    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+    // Processor is overloaded, no priority order can work
+    if (ret.utilization > 1.0) {
+        return ret;
+    }
 
-        Task *task = &(task_set->tasks[i]);
+    // Sort once into priority order (shortest period first) so each task's
+    // interference comes from the prefix of tasks before it
+    PRIORITY_SET_ON_STACK(set, task_set->num_tasks);
+    double blocking[task_set->num_tasks + 1];
+    if (blocking_applies(task_set)) {
+        // Filled in along with the order, which the ceilings depend on
+        set.blocking = blocking;
+    }
+    priority_set_build(&set, task_set, PRIORITY_BY_PERIOD);
 
-        double a_n, a_n1 = 0;
+    // Cheap sufficient test first, exact response times only if it can't tell
+    if (rta_bound_schedulable(&set)) {
+        ret.tier = TIER_BOUND;
+        ret.is_schedulable = 1;
+        return ret;
+    }
 
-        for (;;) {
+    ret.tier = TIER_EXACT;
+    if (!rta_exact_schedulable(&set, &ret.method)) {
+        // Some task's response time exceeds its deadline
+        return ret;
+    }
 
-            a_n = a_n1;
-            a_n1 = task->wcet;
-            int passed_task = 0;
+    // If we reach here, task is schedulable
+    ret.is_schedulable = 1;
+    return ret;
 
-            for (unsigned int j = 0; j < task_set->num_tasks; j++) {
+}
 
-                Task *hp_task = &(task_set->tasks[j]);
+analysis_results rm_analysis_ticks(TaskSet *task_set) {
 
-                // Tasks aren't sorted by priority (yet?) so we need to find the
-                // ones with higher priorities (shorter periods) that can preempt
-                if (task == hp_task) {
-                	passed_task++;
-                }
+    analysis_results ret = {0, 0, TIER_UTILIZATION};
 
-                if ((hp_task->period < task->period) || (hp_task->period == task->period && !passed_task)) {
-                    a_n1 += ceil(a_n / hp_task->period) * hp_task->wcet;
-                }
-            }
+    // Reported from the doubles so the output matches the double analysis
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        Task task = task_set->tasks[i];
+        ret.utilization += task.wcet / task.period;
+    }
 
-            // Fuzzy double equality check to account for fp precision errors
-            if (fabs(a_n1 - a_n) < 0.0001) {
-                // Current task is potentially schedulable
-                break;
-            }
+    if (ticks_compare_utilization(task_set) > 0) {
+        return ret;
+    }
 
-            if (a_n1 > task->period) {
-                // Still not schedulable
-                return ret;
-            }
-        }
+    PRIORITY_SET_TICKS_ON_STACK(set, task_set->num_tasks);
+    priority_set_build_ticks(&set, task_set, PRIORITY_BY_PERIOD);
 
-        // After the for(;;) loop is broken, a_n1 represents worst case response
-        // time after critical instance
-        if (a_n1 > task->deadline) {
-            // Still not schedulable
-            return ret;
-        }
+    if (rta_bound_schedulable_ticks(&set)) {
+        ret.tier = TIER_BOUND;
+        ret.is_schedulable = 1;
+        return ret;
     }
 
-    // If we reach here, task is schedulable
-    ret.is_schedulable = 1;
+    ret.tier = TIER_EXACT;
+    ret.is_schedulable = rta_exact_schedulable_ticks(&set, &ret.method);
     return ret;
 
-}
\ No newline at end of file
+}
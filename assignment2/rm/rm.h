@@ -3,4 +3,7 @@
 
 analysis_results rm_analysis (TaskSet *task_set);
 
+// Exact analysis over task_set->ticks
+analysis_results rm_analysis_ticks (TaskSet *task_set);
+
 #endif //RM_H
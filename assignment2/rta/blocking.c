@@ -0,0 +1,218 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blocking.h"
+#include "rta.h"
+
+static LockingProtocol selected = PROTOCOL_PIP;
+
+void blocking_use(LockingProtocol protocol) {
+
+    selected = protocol;
+
+}
+
+int blocking_parse(const char *name, LockingProtocol *protocol) {
+
+    static const char *names[] = {"none", "pip", "pcp"};
+
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *protocol = (LockingProtocol) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int blocking_applies(TaskSet *task_set) {
+
+    return task_set->num_sections > 0 && selected != PROTOCOL_NONE;
+
+}
+
+/*
+ * Fenwick tree over priority levels for prefix maxima, tree[1..n]. Entries
+ * only ever grow, which is all PCP's sweep needs.
+ */
+static void fenwick_raise(double *tree, unsigned int n, unsigned int level, double value) {
+
+    for (unsigned int k = level + 1; k <= n; k += k & -k) {
+        tree[k] = fmax(tree[k], value);
+    }
+}
+
+// Largest value raised at any level up to and including level
+static double fenwick_max(const double *tree, unsigned int level) {
+
+    double best = 0.0;
+    for (unsigned int k = level + 1; k > 0; k -= k & -k) {
+        best = fmax(best, tree[k]);
+    }
+    return best;
+}
+
+/*
+ * A section of the task at level j on a resource with ceiling c blocks the
+ * levels c..j-1. Sweeping up from the lowest priority, the sections of
+ * level j go into the tree at their ceilings just before level j-1 is
+ * reached, so the prefix maximum up to level i covers exactly the sections
+ * of lower levels whose ceiling is at least as high as i.
+ */
+static void pcp_terms(unsigned int n, unsigned int m, const CriticalSection *sections,
+                      const unsigned int *level, const unsigned int *ceiling, double *blocking) {
+
+    unsigned int *start = calloc(n + 2, sizeof(unsigned int));
+    unsigned int *by_level = malloc((m + 1) * sizeof(unsigned int));
+    double *tree = calloc(n + 1, sizeof(double));
+
+    // Counting sort of the sections by their task's level
+    for (unsigned int s = 0; s < m; s++) {
+        start[level[s] + 2]++;
+    }
+    for (unsigned int k = 2; k <= n + 1; k++) {
+        start[k] += start[k - 1];
+    }
+    for (unsigned int s = 0; s < m; s++) {
+        by_level[start[level[s] + 1]++] = s;
+    }
+
+    for (unsigned int i = n; i-- > 0;) {
+        for (unsigned int k = start[i + 1]; k < start[i + 2]; k++) {
+            unsigned int s = by_level[k];
+            fenwick_raise(tree, n, ceiling[s], sections[s].length);
+        }
+        blocking[i] = fenwick_max(tree, i);
+    }
+
+    free(start);
+    free(by_level);
+    free(tree);
+}
+
+/*
+ * Both PIP sums are step functions of the level, so each is built as a
+ * difference array and summed up once. by_resource lists the sections by
+ * resource and then level, by_task by level and then ceiling.
+ */
+static void pip_terms(unsigned int n, unsigned int m, const CriticalSection *sections,
+                      const unsigned int *level, const unsigned int *ceiling,
+                      const unsigned int *by_resource, const unsigned int *by_task, double *blocking) {
+
+    double *per_task = calloc(n + 1, sizeof(double));
+    double *per_resource = calloc(n + 1, sizeof(double));
+
+    // Level j's longest section with ceiling at most i, for the levels i < j.
+    // It only changes at the ceilings of its sections, where it grows
+    for (unsigned int k = 0; k < m;) {
+        unsigned int j = level[by_task[k]];
+        double longest = 0.0;
+        for (; k < m && level[by_task[k]] == j; k++) {
+            unsigned int s = by_task[k];
+            if (ceiling[s] < j && sections[s].length > longest) {
+                per_task[ceiling[s]] += sections[s].length - longest;
+                per_task[j] -= sections[s].length - longest;
+                longest = sections[s].length;
+            }
+        }
+    }
+
+    // A resource's longest section below level i, from its ceiling on.
+    // Between two of its users' levels that is the longest of the lower ones
+    for (unsigned int k = 0; k < m;) {
+        unsigned int end = k;
+        while (end < m && sections[by_resource[end]].resource == sections[by_resource[k]].resource) {
+            end++;
+        }
+
+        double longest = 0.0;
+        for (unsigned int t = end - 1; t > k; t--) {
+            unsigned int above = level[by_resource[t - 1]], user = level[by_resource[t]];
+            longest = fmax(longest, sections[by_resource[t]].length);
+            per_resource[above] += longest;
+            per_resource[user] -= longest;
+        }
+        k = end;
+    }
+
+    double task_sum = 0.0, resource_sum = 0.0;
+    for (unsigned int i = 0; i < n; i++) {
+        task_sum += per_task[i];
+        resource_sum += per_resource[i];
+        // The differences cancel to 0 up to rounding, never below it
+        blocking[i] = fmax(0.0, fmin(task_sum, resource_sum));
+    }
+
+    free(per_task);
+    free(per_resource);
+}
+
+void blocking_terms(TaskSet *task_set, const unsigned int *index, double *blocking) {
+
+    unsigned int n = task_set->num_tasks, m = task_set->num_sections;
+    const CriticalSection *sections = task_set->sections;
+
+    memset(blocking, 0, n * sizeof(double));
+    if (m == 0 || selected == PROTOCOL_NONE) {
+        return;
+    }
+
+    // Sections can far outnumber tasks, so their scratch is on the heap
+    unsigned int *level_of = malloc((n + 1) * sizeof(unsigned int));
+    unsigned int *level = malloc((m + 1) * sizeof(unsigned int));
+    unsigned int *ceiling = malloc((m + 1) * sizeof(unsigned int));
+    unsigned int *by_resource = malloc((m + 1) * sizeof(unsigned int));
+    unsigned int *by_task = malloc((m + 1) * sizeof(unsigned int));
+    unsigned int *scratch = malloc((m + 1) * sizeof(unsigned int));
+    double *key = malloc((m + 1) * sizeof(double));
+
+    for (unsigned int k = 0; k < n; k++) {
+        level_of[index[k]] = k;
+    }
+
+    // By level and then, as the sort is stable, by resource. Combined into
+    // one key the two could pass 2^53 and stop being exact in a double
+    for (unsigned int s = 0; s < m; s++) {
+        level[s] = level_of[sections[s].task];
+        key[s] = level[s];
+        by_resource[s] = s;
+    }
+    sort_indices(by_resource, scratch, key, m);
+    for (unsigned int s = 0; s < m; s++) {
+        key[s] = sections[s].resource;
+    }
+    sort_indices(by_resource, scratch, key, m);
+
+    // A resource's first section by level belongs to its highest priority user
+    for (unsigned int k = 0; k < m; k++) {
+        unsigned int s = by_resource[k];
+        int first = k == 0 || sections[by_resource[k - 1]].resource != sections[s].resource;
+        ceiling[s] = first ? level[s] : ceiling[by_resource[k - 1]];
+    }
+
+    if (selected == PROTOCOL_PCP) {
+        pcp_terms(n, m, sections, level, ceiling, blocking);
+    } else {
+        // By ceiling and then by level, the same way
+        for (unsigned int s = 0; s < m; s++) {
+            key[s] = ceiling[s];
+            by_task[s] = s;
+        }
+        sort_indices(by_task, scratch, key, m);
+        for (unsigned int s = 0; s < m; s++) {
+            key[s] = level[s];
+        }
+        sort_indices(by_task, scratch, key, m);
+        pip_terms(n, m, sections, level, ceiling, by_resource, by_task, blocking);
+    }
+
+    free(level_of);
+    free(level);
+    free(ceiling);
+    free(by_resource);
+    free(by_task);
+    free(scratch);
+    free(key);
+}
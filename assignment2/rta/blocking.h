@@ -0,0 +1,48 @@
+#ifndef BLOCKING_H
+#define BLOCKING_H
+
+#include "../task_types.h"
+
+/*
+ * Blocking terms B_i for response-time analysis with shared resources,
+ *
+ *     R_i = C_i + B_i + ∑(j∈hp(i), ⌈R_i/P_j⌉ * C_j)
+ *
+ * The ceiling of a resource is the highest priority of the tasks using it.
+ * A lower priority task's critical section on a resource whose ceiling is
+ * at least task i's priority can delay task i:
+ *
+ *     PCP: B_i = the longest such section, as at most one can block
+ *     PIP: B_i = min(∑ over lower tasks of each one's longest such section,
+ *                    ∑ over such resources of their longest lower section)
+ *
+ * as under priority inheritance a task can be blocked once per lower
+ * priority task and once per resource.
+ */
+
+typedef enum LockingProtocol {
+
+    PROTOCOL_NONE,  // Critical sections are ignored
+    PROTOCOL_PIP,   // Priority inheritance, the default
+    PROTOCOL_PCP,   // Priority ceiling
+
+} LockingProtocol;
+
+// Picks the protocol every later analysis assumes. Call before any runs
+void blocking_use(LockingProtocol protocol);
+
+// Parses "none", "pip" or "pcp", returns -1 otherwise
+int blocking_parse(const char *name, LockingProtocol *protocol);
+
+// Returns 1 if task_set has critical sections and they aren't being ignored
+int blocking_applies(TaskSet *task_set);
+
+/*
+ * Fills blocking[k] with the blocking term of task index[k], where index
+ * lists task_set's tasks from highest to lowest priority. Ceilings are
+ * worked out once, after which a sweep over the priority levels finds every
+ * task's term in O((n + s) log(n + s)) for n tasks and s sections.
+ */
+void blocking_terms(TaskSet *task_set, const unsigned int *index, double *blocking);
+
+#endif //BLOCKING_H
@@ -0,0 +1,168 @@
+#include <math.h>
+#include <pthread.h>
+#include <string.h>
+
+#include "interference.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_KERNELS 1
+#endif
+
+/*
+ * a * inv_period is within a few ulps of a / period. If no integer lies
+ * within GUARD (relative) of the product, both have the same ceiling.
+ */
+#define GUARD 0x1p-49
+
+static interference_fn selected;
+static pthread_once_t selected_once = PTHREAD_ONCE_INIT;
+
+static void interference_scalar(double a, const double *wcet, const double *period,
+                                const double *inv_period, unsigned int count, double *terms) {
+
+    for (unsigned int j = 0; j < count; j++) {
+        terms[j] = ceil(a / period[j]) * wcet[j];
+    }
+}
+
+#ifdef HAVE_X86_KERNELS
+
+__attribute__((target("sse4.1")))
+static void interference_sse4(double a, const double *wcet, const double *period,
+                              const double *inv_period, unsigned int count, double *terms) {
+
+    const __m128d va = _mm_set1_pd(a);
+    const __m128d guard = _mm_set1_pd(GUARD);
+    unsigned int j = 0;
+
+    for (; j + 2 <= count; j += 2) {
+
+        __m128d q = _mm_mul_pd(va, _mm_loadu_pd(&inv_period[j]));
+        __m128d m = _mm_mul_pd(q, guard);
+        __m128d lo = _mm_ceil_pd(_mm_sub_pd(q, m));
+        __m128d hi = _mm_ceil_pd(_mm_add_pd(q, m));
+
+        // Near an integer, divide like the scalar kernel does
+        if (_mm_movemask_pd(_mm_cmpneq_pd(lo, hi))) {
+            hi = _mm_ceil_pd(_mm_div_pd(va, _mm_loadu_pd(&period[j])));
+        }
+
+        _mm_storeu_pd(&terms[j], _mm_mul_pd(hi, _mm_loadu_pd(&wcet[j])));
+    }
+
+    interference_scalar(a, wcet + j, period + j, inv_period + j, count - j, terms + j);
+}
+
+__attribute__((target("avx2")))
+static inline __m256d interference_avx2_block(__m256d va, __m256d guard, const double *wcet,
+                                              const double *period, const double *inv_period) {
+
+    __m256d q = _mm256_mul_pd(va, _mm256_loadu_pd(inv_period));
+    __m256d m = _mm256_mul_pd(q, guard);
+    __m256d lo = _mm256_ceil_pd(_mm256_sub_pd(q, m));
+    __m256d hi = _mm256_ceil_pd(_mm256_add_pd(q, m));
+
+    // Near an integer, divide like the scalar kernel does
+    if (_mm256_movemask_pd(_mm256_cmp_pd(lo, hi, _CMP_NEQ_UQ))) {
+        hi = _mm256_ceil_pd(_mm256_div_pd(va, _mm256_loadu_pd(period)));
+    }
+
+    return _mm256_mul_pd(hi, _mm256_loadu_pd(wcet));
+}
+
+__attribute__((target("avx2")))
+static void interference_avx2(double a, const double *wcet, const double *period,
+                              const double *inv_period, unsigned int count, double *terms) {
+
+    const __m256d va = _mm256_set1_pd(a);
+    const __m256d guard = _mm256_set1_pd(GUARD);
+    unsigned int j = 0;
+
+    // Eight tasks per iteration, two independent vectors in flight
+    for (; j + 8 <= count; j += 8) {
+        __m256d t0 = interference_avx2_block(va, guard, wcet + j, period + j, inv_period + j);
+        __m256d t1 = interference_avx2_block(va, guard, wcet + j + 4, period + j + 4,
+                                             inv_period + j + 4);
+        _mm256_storeu_pd(&terms[j], t0);
+        _mm256_storeu_pd(&terms[j + 4], t1);
+    }
+
+    for (; j + 4 <= count; j += 4) {
+        _mm256_storeu_pd(&terms[j],
+                         interference_avx2_block(va, guard, wcet + j, period + j, inv_period + j));
+    }
+
+    // The rest of the program is legacy SSE code, clear the upper halves
+    // before running any of it to avoid the AVX/SSE transition penalty
+    _mm256_zeroupper();
+
+    interference_sse4(a, wcet + j, period + j, inv_period + j, count - j, terms + j);
+}
+
+#endif
+
+static interference_fn kernel_for(InterferenceKernel kernel) {
+
+    switch (kernel) {
+        case KERNEL_SCALAR:
+            return interference_scalar;
+#ifdef HAVE_X86_KERNELS
+        case KERNEL_SSE4:
+            return __builtin_cpu_supports("sse4.1") ? interference_sse4 : NULL;
+        case KERNEL_AVX2:
+            // The AVX2 kernel finishes its tail with the SSE4 one
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.1")
+                   ? interference_avx2 : NULL;
+#endif
+        case KERNEL_AUTO:
+            for (InterferenceKernel k = KERNEL_AVX2; k > KERNEL_AUTO; k--) {
+                if (kernel_for(k) != NULL) {
+                    return kernel_for(k);
+                }
+            }
+            return interference_scalar;
+        default:
+            return NULL;
+    }
+}
+
+static void select_default(void) {
+
+    if (selected == NULL) {
+        selected = kernel_for(KERNEL_AUTO);
+    }
+}
+
+interference_fn interference_kernel(void) {
+
+    pthread_once(&selected_once, select_default);
+    return selected;
+
+}
+
+int interference_use(InterferenceKernel kernel) {
+
+    interference_fn fn = kernel_for(kernel);
+    if (fn == NULL) {
+        return 0;
+    }
+
+    selected = fn;
+    pthread_once(&selected_once, select_default);
+    return 1;
+}
+
+int interference_parse(const char *name, InterferenceKernel *kernel) {
+
+    static const char *names[] = {"auto", "scalar", "sse4", "avx2"};
+
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *kernel = (InterferenceKernel) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
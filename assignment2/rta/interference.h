@@ -0,0 +1,40 @@
+#ifndef INTERFERENCE_H
+#define INTERFERENCE_H
+
+/*
+ * Interference terms of the response-time recurrence,
+ *
+ *     terms[j] = ⌈a / period[j]⌉ * wcet[j]    for j < count
+ *
+ * The vector kernels multiply by precomputed reciprocal periods instead of
+ * dividing. Wherever a / period[j] is close enough to an integer that the
+ * reciprocal's rounding could move the ceiling, they fall back to the
+ * division, so every kernel produces exactly the scalar kernel's terms.
+ */
+
+typedef void (*interference_fn)(double a, const double *wcet, const double *period,
+                                const double *inv_period, unsigned int count, double *terms);
+
+typedef enum InterferenceKernel {
+
+    KERNEL_AUTO,
+    KERNEL_SCALAR,
+    KERNEL_SSE4,
+    KERNEL_AVX2,
+
+} InterferenceKernel;
+
+// Best kernel the CPU supports, or the one forced by interference_use
+interference_fn interference_kernel(void);
+
+/*
+ * Forces a kernel, mostly for checking the vector kernels against the
+ * scalar one. Must be called before any analysis runs. Returns 0 if the CPU
+ * doesn't support the kernel.
+ */
+int interference_use(InterferenceKernel kernel);
+
+// Parses "auto", "scalar", "sse4" or "avx2", returns -1 otherwise
+int interference_parse(const char *name, InterferenceKernel *kernel);
+
+#endif //INTERFERENCE_H
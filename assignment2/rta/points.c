@@ -0,0 +1,191 @@
+#include <math.h>
+#include <stddef.h>
+
+#include "points.h"
+#include "interference.h"
+#include "../instrument/instrument.h"
+
+typedef struct PointSearch {
+
+    PrioritySet *set;
+    unsigned int task;
+
+    // C_i + B_i
+    double own;
+
+    interference_fn interference;
+    double *terms;
+
+    unsigned long budget;
+    int unsure;
+
+} PointSearch;
+
+typedef struct PointSearchTicks {
+
+    PrioritySetTicks *set;
+    unsigned int task;
+    unsigned long budget;
+
+} PointSearchTicks;
+
+/*
+ * t / period rounded to a whole number of periods if it is within
+ * POINTS_EPSILON of one, so a point on a release counts that release
+ * whatever the rounding of t did. Sets *whole if it was.
+ */
+static double periods_in(double t, double period, int *whole) {
+
+    double q = t / period;
+    double nearest = round(q);
+
+    *whole = fabs(q - nearest) <= POINTS_EPSILON * q;
+    return *whole ? nearest : q;
+}
+
+static int fits(PointSearch *search, double t) {
+
+    PrioritySet *set = search->set;
+    double demand = search->own;
+    int whole;
+
+    INSTRUMENT_ITERATION();
+    search->budget--;
+
+    // The iteration's own terms first. Their ceilings are never below the
+    // rounded ones, so if these fit those do
+    search->interference(t, set->wcet, set->period, set->inv_period, search->task, search->terms);
+    for (unsigned int j = 0; j < search->task; j++) {
+        demand += search->terms[j];
+    }
+
+    if (demand <= t * (1.0 - POINTS_EPSILON)) {
+        return 1;
+    }
+
+    // A point computed as a multiple of one period can come out just past
+    // that release, or another on it, so count again without those
+    demand = search->own;
+    for (unsigned int j = 0; j < search->task; j++) {
+        demand += ceil(periods_in(t, set->period[j], &whole)) * set->wcet[j];
+    }
+
+    if (demand <= t * (1.0 - POINTS_EPSILON)) {
+        return 1;
+    }
+
+    // Too close to the point to call
+    if (demand <= t * (1.0 + POINTS_EPSILON)) {
+        search->unsure = 1;
+    }
+
+    return 0;
+}
+
+/*
+ * Looks for a point of P_j(t) the task fits by. Unrolled, the recurrence is
+ *
+ *     P_j(t) = {t} ∪ ⋃(k<j, P_k(⌊t/P_k⌋ * P_k))
+ *
+ * so t comes first and every branch starts from one task's last release.
+ */
+static int search_points(PointSearch *search, double t, unsigned int j) {
+
+    if (search->budget == 0) {
+        search->unsure = 1;
+        return 0;
+    }
+
+    if (fits(search, t)) {
+        return 1;
+    }
+
+    for (unsigned int k = 0; k < j; k++) {
+
+        // The last release of task k before t, unless t is one itself
+        int whole;
+        double releases = floor(periods_in(t, search->set->period[k], &whole));
+        if (whole || releases == 0) {
+            continue;
+        }
+
+        if (search_points(search, releases * search->set->period[k], k)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+PointsVerdict points_task(PrioritySet *set, unsigned int i, unsigned long budget) {
+
+    double own = set->blocking != NULL ? set->wcet[i] + set->blocking[i] : set->wcet[i];
+    double terms[i + 1];
+    PointSearch search = {set, i, own, interference_kernel(), terms, budget, 0};
+
+    // Nothing of its own to do, done at 0 as in the response-time iteration
+    if (own <= 0) {
+        return POINTS_MEET;
+    }
+
+    if (search_points(&search, fmin(set->deadline[i], set->period[i]), i)) {
+        return POINTS_MEET;
+    }
+
+    return search.unsure ? POINTS_UNSURE : POINTS_MISS;
+}
+
+// 1 if the task fits by a point of P_j(t), -1 if out of budget
+static int search_points_ticks(PointSearchTicks *search, ticks_t t, unsigned int j) {
+
+    PrioritySetTicks *set = search->set;
+    ticks_t demand = set->wcet[search->task];
+
+    if (search->budget == 0) {
+        return -1;
+    }
+
+    INSTRUMENT_ITERATION();
+    search->budget--;
+
+    for (unsigned int k = 0; k < search->task; k++) {
+        demand += ticks_ceil_div(t, set->period[k]) * set->wcet[k];
+    }
+
+    if (demand <= t) {
+        return 1;
+    }
+
+    for (unsigned int k = 0; k < j; k++) {
+
+        ticks_t release = t / set->period[k] * set->period[k];
+        if (release == t || release == 0) {
+            continue;
+        }
+
+        int found = search_points_ticks(search, release, k);
+        if (found != 0) {
+            return found;
+        }
+    }
+
+    return 0;
+}
+
+PointsVerdict points_task_ticks(PrioritySetTicks *set, unsigned int i, unsigned long budget) {
+
+    PointSearchTicks search = {set, i, budget};
+
+    if (set->wcet[i] == 0) {
+        return POINTS_MEET;
+    }
+
+    switch (search_points_ticks(&search, ticks_min(set->deadline[i], set->period[i]), i)) {
+        case 1:
+            return POINTS_MEET;
+        case 0:
+            return POINTS_MISS;
+        default:
+            return POINTS_UNSURE;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef POINTS_H
+#define POINTS_H
+
+#include "rta.h"
+
+/*
+ * Scheduling point test (Lehoczky, Sha & Ding), the exact alternative to
+ * the response-time iteration. Task i meets its deadline iff the work due
+ * by some point t within its window does fit:
+ *
+ *     ∃ t ∈ P_{i-1}(min(D_i, P_i)):  C_i + B_i + ∑(j<i, ⌈t/P_j⌉ * C_j) <= t
+ *
+ * with the points pruned as Bini & Buttazzo do, down to the last release of
+ * each higher priority task before t:
+ *
+ *     P_0(t) = {t}
+ *     P_j(t) = P_{j-1}(⌊t/P_j⌋ * P_j) ∪ P_{j-1}(t)
+ *
+ * The points are searched depth first from t = min(D_i, P_i) itself, so a
+ * task with slack usually passes at its first point. A missing task has to
+ * try them all, up to 2^i of them.
+ */
+
+// Relative distance from an integer or from the point inside which the
+// doubles can't tell
+#define POINTS_EPSILON 1e-9
+
+// Iterations of the response-time recurrence one point costs about as much
+// as, the search's bookkeeping and the recount of a point that misses with it
+#define POINTS_COST 4.0
+
+typedef enum PointsVerdict {
+
+    POINTS_MISS,
+    POINTS_MEET,
+
+    // Some point is too close to call in doubles, or the search ran out of
+    // budget. Needs the response-time iteration instead
+    POINTS_UNSURE,
+
+} PointsVerdict;
+
+/*
+ * Checks task i of set, giving up after budget points. As with the
+ * response-time iteration the tasks before i must meet their deadlines.
+ */
+PointsVerdict points_task(PrioritySet *set, unsigned int i, unsigned long budget);
+
+// Exact version over integer ticks, only unsure when out of budget
+PointsVerdict points_task_ticks(PrioritySetTicks *set, unsigned int i, unsigned long budget);
+
+#endif //POINTS_H
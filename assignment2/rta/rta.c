@@ -0,0 +1,635 @@
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "rta.h"
+#include "blocking.h"
+#include "interference.h"
+#include "points.h"
+#include "../instrument/instrument.h"
+
+// Response-time iterations stop once a step is shorter than this
+#define TOLERANCE 0.0001
+
+void sort_indices(unsigned int *index, unsigned int *scratch, const double *key, unsigned int n) {
+
+    for (unsigned int width = 1; width < n; width *= 2) {
+
+        for (unsigned int lo = 0; lo < n; lo += 2 * width) {
+
+            unsigned int mid = lo + width < n ? lo + width : n;
+            unsigned int hi = lo + 2 * width < n ? lo + 2 * width : n;
+            unsigned int a = lo, b = mid, out = lo;
+
+            while (a < mid && b < hi) {
+                // Taking from the left run on ties keeps the sort stable
+                scratch[out++] = key[index[b]] < key[index[a]] ? index[b++] : index[a++];
+            }
+            while (a < mid) {
+                scratch[out++] = index[a++];
+            }
+            while (b < hi) {
+                scratch[out++] = index[b++];
+            }
+        }
+
+        for (unsigned int i = 0; i < n; i++) {
+            index[i] = scratch[i];
+        }
+    }
+}
+
+void priority_order(unsigned int *index, TaskSet *task_set, PriorityOrder order) {
+
+    unsigned int n = task_set->num_tasks;
+    unsigned int scratch[n + 1];
+    double key[n + 1];
+
+    for (unsigned int i = 0; i < n; i++) {
+        Task *task = &task_set->tasks[i];
+        key[i] = order == PRIORITY_BY_PERIOD ? task->period : task->deadline;
+        index[i] = i;
+    }
+
+    sort_indices(index, scratch, key, n);
+}
+
+void priority_set_build(PrioritySet *set, TaskSet *task_set, PriorityOrder order) {
+
+    unsigned int n = task_set->num_tasks;
+    unsigned int index[n + 1];
+
+    priority_order(index, task_set, order);
+
+    set->num_tasks = n;
+    for (unsigned int k = 0; k < n; k++) {
+        Task *task = &task_set->tasks[index[k]];
+        set->wcet[k] = task->wcet;
+        set->period[k] = task->period;
+        set->deadline[k] = task->deadline;
+        set->inv_period[k] = 1.0 / task->period;
+    }
+
+    if (set->blocking != NULL) {
+        blocking_terms(task_set, index, set->blocking);
+    }
+
+    if (set->input != NULL) {
+        memcpy(set->input, index, n * sizeof(unsigned int));
+    }
+}
+
+void priority_set_build_ticks(PrioritySetTicks *set, TaskSet *task_set, PriorityOrder order) {
+
+    unsigned int n = task_set->num_tasks;
+    unsigned int index[n + 1];
+
+    // Ticks are the doubles scaled exactly, so the order is the same
+    priority_order(index, task_set, order);
+
+    set->num_tasks = n;
+    for (unsigned int k = 0; k < n; k++) {
+        TaskTicks *task = &task_set->ticks[index[k]];
+        set->wcet[k] = task->wcet;
+        set->period[k] = task->period;
+        set->deadline[k] = task->deadline;
+    }
+}
+
+/*
+ * The higher priority tasks of the task being analyzed sorted by
+ * set->input, with their parameters gathered so the kernel's terms come
+ * out in the order they are summed in. Going down the priorities each task
+ * only adds the one above it.
+ */
+typedef struct InputOrder {
+
+    unsigned int count;
+    unsigned int *input;
+    double *wcet;
+    double *period;
+    double *inv_period;
+
+} InputOrder;
+
+#define INPUT_ORDER_ON_STACK(name, n)                                           \
+    unsigned int name##_input[(n) + 1];                                         \
+    double name##_storage[3 * (n) + 1];                                         \
+    InputOrder name = {0, name##_input, name##_storage, name##_storage + (n),   \
+                       name##_storage + 2 * (n)}
+
+// Makes order hold tasks 0..i-1 of set
+static void input_order_advance(InputOrder *order, PrioritySet *set, unsigned int i) {
+
+    if (order->count > i) {
+        order->count = 0;
+    }
+
+    for (unsigned int k = order->count; k < i; k++) {
+
+        // Insertion sort, tasks listed in priority order cost nothing to add
+        unsigned int p = k;
+        while (p > 0 && order->input[p - 1] > set->input[k]) {
+            order->input[p] = order->input[p - 1];
+            order->wcet[p] = order->wcet[p - 1];
+            order->period[p] = order->period[p - 1];
+            order->inv_period[p] = order->inv_period[p - 1];
+            p--;
+        }
+
+        order->input[p] = set->input[k];
+        order->wcet[p] = set->wcet[k];
+        order->period[p] = set->period[k];
+        order->inv_period[p] = set->inv_period[k];
+    }
+
+    order->count = i;
+}
+
+/*
+ * Worst-case response time of task i of set, or INFINITY once the
+ * recurrence passes the task's period. start must not exceed the response
+ * time, 0 always works
+ *
+ *     w_i_n+1 = e_i + b_i + ∑(j∈hp(i), ⌈w_i_n/p_j⌉ * e_j)
+ *         -> {hp(i)} is 0..i-1 once the set is in priority order
+ *         -> b_i the blocking term, if any
+ */
+static double response_time(PrioritySet *set, unsigned int i, double start,
+                            interference_fn interference, double *terms, InputOrder *order) {
+
+    double a_n, a_n1 = start;
+    double own = set->blocking != NULL ? set->wcet[i] + set->blocking[i] : set->wcet[i];
+
+    const double *wcet = set->wcet, *period = set->period, *inv_period = set->inv_period;
+    if (set->input != NULL) {
+        input_order_advance(order, set, i);
+        wcet = order->wcet;
+        period = order->period;
+        inv_period = order->inv_period;
+    }
+
+    for (;;) {
+
+        a_n = a_n1;
+        a_n1 = own;
+        INSTRUMENT_ITERATION();
+
+        // Terms are summed in the same order whichever kernel made them,
+        // so every kernel gives bit-identical response times
+        interference(a_n, wcet, period, inv_period, i, terms);
+        for (unsigned int j = 0; j < i; j++) {
+            a_n1 += terms[j];
+        }
+
+        // Fuzzy double equality check to account for fp precision errors
+        if (fabs(a_n1 - a_n) < TOLERANCE) {
+            // After the loop is broken, a_n1 represents worst case response
+            // time after critical instance
+            return a_n1;
+        }
+
+        if (a_n1 > set->period[i]) {
+            // Still not schedulable
+            return INFINITY;
+        }
+    }
+}
+
+int rta_schedulable(PrioritySet *set) {
+
+    interference_fn interference = interference_kernel();
+    double terms[set->num_tasks + 1];
+    INPUT_ORDER_ON_STACK(hp, set->num_tasks);
+
+    for (unsigned int i = 0; i < set->num_tasks; i++) {
+        double response = response_time(set, i, 0.0, interference, terms, &hp);
+        INSTRUMENT_TASK(i);
+        if (response > set->deadline[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * Returns 1 if t lies within the iteration's tolerance of a release of one
+ * of tasks 0..i-1 of set. Iterations from two starting points can round to
+ * the two sides of such a release and count one job more or less.
+ */
+static int near_release(PrioritySet *set, unsigned int i, double t) {
+
+    for (unsigned int j = 0; j < i; j++) {
+        double release = nearbyint(t * set->inv_period[j]) * set->period[j];
+        if (fabs(t - release) < TOLERANCE) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int rta_schedulable_from(PrioritySet *set, unsigned int first, double *response) {
+
+    interference_fn interference = interference_kernel();
+    double terms[set->num_tasks + 1];
+    INPUT_ORDER_ON_STACK(hp, set->num_tasks);
+
+    for (unsigned int i = first; i < set->num_tasks; i++) {
+
+        double start = response[i];
+        response[i] = response_time(set, i, start, interference, terms, &hp);
+
+        // Settled on a release, or past the period, where an iteration from
+        // 0 may have ended on the other side, so it has the last word
+        if (start > 0.0 && (isinf(response[i]) || near_release(set, i, response[i]))) {
+            response[i] = response_time(set, i, 0.0, interference, terms, &hp);
+        }
+
+        INSTRUMENT_TASK(i);
+        if (response[i] > set->deadline[i]) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void rta_response_times(TaskSet *task_set, PriorityOrder order, double *response) {
+
+    unsigned int n = task_set->num_tasks;
+    unsigned int index[n + 1];
+    PRIORITY_SET_ON_STACK(set, n);
+    double blocking[n + 1];
+
+    priority_order(index, task_set, order);
+    for (unsigned int k = 0; k < n; k++) {
+        Task *task = &task_set->tasks[index[k]];
+        set.wcet[k] = task->wcet;
+        set.period[k] = task->period;
+        set.deadline[k] = task->deadline;
+        set.inv_period[k] = 1.0 / task->period;
+        set.input[k] = index[k];
+    }
+
+    if (blocking_applies(task_set)) {
+        set.blocking = blocking;
+        blocking_terms(task_set, index, blocking);
+    }
+
+    interference_fn interference = interference_kernel();
+    double terms[n + 1];
+    INPUT_ORDER_ON_STACK(hp, n);
+
+    // Tasks past the period don't stop the analysis of lower priorities
+    for (unsigned int k = 0; k < n; k++) {
+        response[index[k]] = response_time(&set, k, 0.0, interference, terms, &hp);
+    }
+}
+
+/*
+ * Sums within this fraction of a threshold may land on either side of it
+ * when taken in another order
+ */
+#define ORDER_MARGIN 1e-6
+
+static inline int near_threshold(double sum, double threshold) {
+
+    return fabs(sum - threshold) <= threshold * ORDER_MARGIN;
+
+}
+
+int rta_order_sensitive(TaskSet *task_set, PriorityOrder order, int exact) {
+
+    unsigned int n = task_set->num_tasks;
+    PRIORITY_SET_ON_STACK(set, n);
+    priority_set_build(&set, task_set, order);
+
+    // The bounds of rta_bound_schedulable, if they apply to the order
+    double density = 0.0, product = 1.0, previous = 0.0;
+    int monotonic = 1;
+
+    for (unsigned int i = 0; i < n; i++) {
+        double window = fmin(set.deadline[i], set.period[i]);
+        monotonic = monotonic && window >= previous;
+        previous = window;
+        density += set.wcet[i] / window;
+        product *= set.wcet[i] / window + 1.0;
+    }
+
+    if (n > 0 && monotonic && (near_threshold(density, n * (exp2(1.0 / n) - 1.0) - RTA_BOUND_MARGIN)
+                               || near_threshold(product, 2.0 - RTA_BOUND_MARGIN))) {
+        return 1;
+    }
+
+    /*
+     * Each response time, up to the first that misses, must stay clear of
+     * the deadline and period, where a few ulps decide the verdict. One
+     * that lands on a release may round past it in another order and count
+     * that job, so the iteration goes on from just past the release too,
+     * and must give the same verdict. Sums of up to two nonzero terms come
+     * out the same in either order.
+     */
+    for (unsigned int i = 0; exact && i < n; i++) {
+
+        double a_n, a_n1 = 0.0, previous_response = -1.0;
+        unsigned int terms;
+        int meets, verdict = -1;
+
+        for (;;) {
+
+            a_n = a_n1;
+            a_n1 = set.wcet[i];
+            terms = set.wcet[i] > 0.0;
+            for (unsigned int j = 0; j < i; j++) {
+                double term = ceil(a_n * set.inv_period[j]) * set.wcet[j];
+                a_n1 += term;
+                terms += term > 0.0;
+            }
+
+            int converged = fabs(a_n1 - a_n) < TOLERANCE;
+            if (!converged && a_n1 <= set.period[i]) {
+                continue;
+            }
+
+            if (terms > 2 && (fabs(a_n1 - set.deadline[i]) < TOLERANCE || fabs(a_n1 - set.period[i]) < TOLERANCE)) {
+                return 1;
+            }
+
+            meets = converged && a_n1 <= set.deadline[i];
+            if (verdict != -1 && meets != verdict) {
+                return 1;
+            }
+            verdict = meets;
+
+            // Past a release just below, the job is counted already
+            if (!meets || terms <= 2 || a_n1 - previous_response < TOLERANCE || !near_release(&set, i, a_n1)) {
+                break;
+            }
+            previous_response = a_n1;
+            a_n1 += TOLERANCE;
+        }
+
+        if (!meets) {
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+// Response-time iteration of task i of set over ticks, 1 if it meets its deadline
+static int task_schedulable_ticks(PrioritySetTicks *set, unsigned int i) {
+
+    ticks_t a_n, a_n1 = set->wcet[i];
+
+    do {
+
+        a_n = a_n1;
+        a_n1 = set->wcet[i];
+        INSTRUMENT_ITERATION();
+
+        for (unsigned int j = 0; j < i; j++) {
+            a_n1 += ticks_ceil_div(a_n, set->period[j]) * set->wcet[j];
+        }
+
+        if (a_n1 > set->period[i]) {
+            return 0;
+        }
+
+    } while (a_n1 != a_n);
+
+    return a_n1 <= set->deadline[i];
+}
+
+int rta_schedulable_ticks(PrioritySetTicks *set) {
+
+    for (unsigned int i = 0; i < set->num_tasks; i++) {
+        int schedulable = task_schedulable_ticks(set, i);
+        INSTRUMENT_TASK(i);
+        if (!schedulable) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static analysis_method forced = METHOD_NONE;
+
+void rta_method_use(analysis_method method) {
+
+    forced = method;
+}
+
+analysis_method rta_method_forced(void) {
+
+    return forced;
+
+}
+
+int rta_method_parse(const char *name, analysis_method *method) {
+
+    // In the order of analysis_method, "auto" standing for METHOD_NONE
+    static const char *names[] = {"auto", "rta", "points"};
+
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        if (strcmp(name, names[i]) == 0) {
+            *method = (analysis_method) i;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Points the search of a task may visit before the iteration takes over,
+ * about as many as P_{i-1}(w) has: one per release of a higher priority
+ * task within the window w, jobs = w * ∑(j<i, 1/P_j), and w itself.
+ */
+static unsigned long points_budget(double jobs) {
+
+    return jobs < 1e9 ? 2 + (unsigned long) jobs : 1000000000UL;
+}
+
+/*
+ * Adds task i's estimated cost under each test to cost[METHOD_RTA] and
+ * cost[METHOD_POINTS], in demand sums weighted by their i + 1 terms. All
+ * it takes are sums over the tasks before i: their utilization, wcets and
+ * releases per unit of time.
+ *
+ *  - The points test stops at its first point, the window w, whenever
+ *    own + w * utilization + wcets <= w, as the demand there is at most
+ *    that. Otherwise it may have to visit all 1 + jobs points, or 2^i
+ *    if fewer. Each point weighs POINTS_COST iterations.
+ *  - The iteration needs a step per new release it runs into, and the
+ *    steps shrink as it closes in, so about 1 + log2(1 + jobs).
+ */
+static void add_task_cost(double *cost, unsigned int i, double own, double window,
+                          double utilization, double wcets, double rate) {
+
+    double jobs = window * rate;
+    double points = own + window * utilization + wcets <= window ? 1.0 : fmin(ldexp(1.0, i), 1.0 + jobs);
+
+    cost[METHOD_RTA] += (i + 1.0) * (1.0 + (i > 0 ? ilogb(1.0 + jobs) : 0));
+    cost[METHOD_POINTS] += (i + 1.0) * points * POINTS_COST;
+}
+
+static analysis_method cheaper_method(PrioritySet *set) {
+
+    double cost[NUM_METHODS] = {0};
+    double utilization = 0.0, wcets = 0.0, rate = 0.0;
+
+    for (unsigned int i = 0; i < set->num_tasks; i++) {
+        double own = set->blocking != NULL ? set->wcet[i] + set->blocking[i] : set->wcet[i];
+        add_task_cost(cost, i, own, fmin(set->deadline[i], set->period[i]), utilization, wcets, rate);
+        utilization += set->wcet[i] * set->inv_period[i];
+        wcets += set->wcet[i];
+        rate += set->inv_period[i];
+    }
+
+    return cost[METHOD_POINTS] < cost[METHOD_RTA] ? METHOD_POINTS : METHOD_RTA;
+}
+
+static analysis_method cheaper_method_ticks(PrioritySetTicks *set) {
+
+    double cost[NUM_METHODS] = {0};
+    double utilization = 0.0, wcets = 0.0, rate = 0.0;
+
+    for (unsigned int i = 0; i < set->num_tasks; i++) {
+        add_task_cost(cost, i, (double) set->wcet[i], (double) ticks_min(set->deadline[i], set->period[i]),
+                      utilization, wcets, rate);
+        utilization += (double) set->wcet[i] / set->period[i];
+        wcets += (double) set->wcet[i];
+        rate += 1.0 / set->period[i];
+    }
+
+    return cost[METHOD_POINTS] < cost[METHOD_RTA] ? METHOD_POINTS : METHOD_RTA;
+}
+
+int rta_exact_schedulable(PrioritySet *set, analysis_method *method) {
+
+    *method = forced != METHOD_NONE ? forced : cheaper_method(set);
+    if (*method == METHOD_RTA) {
+        return rta_schedulable(set);
+    }
+
+    interference_fn interference = interference_kernel();
+    double terms[set->num_tasks + 1];
+    INPUT_ORDER_ON_STACK(hp, set->num_tasks);
+    double rate = 0.0;
+
+    for (unsigned int i = 0; i < set->num_tasks; i++) {
+
+        double window = fmin(set->deadline[i], set->period[i]);
+        PointsVerdict verdict = points_task(set, i, points_budget(window * rate));
+
+        // Out of budget or too close to call, the iteration decides
+        if (verdict == POINTS_UNSURE) {
+            double response = response_time(set, i, 0.0, interference, terms, &hp);
+            verdict = response <= set->deadline[i] ? POINTS_MEET : POINTS_MISS;
+        }
+
+        INSTRUMENT_TASK(i);
+        if (verdict == POINTS_MISS) {
+            return 0;
+        }
+        rate += set->inv_period[i];
+    }
+
+    return 1;
+}
+
+int rta_exact_schedulable_ticks(PrioritySetTicks *set, analysis_method *method) {
+
+    *method = forced != METHOD_NONE ? forced : cheaper_method_ticks(set);
+    if (*method == METHOD_RTA) {
+        return rta_schedulable_ticks(set);
+    }
+
+    double rate = 0.0;
+
+    for (unsigned int i = 0; i < set->num_tasks; i++) {
+
+        ticks_t window = ticks_min(set->deadline[i], set->period[i]);
+        PointsVerdict verdict = points_task_ticks(set, i, points_budget(window * rate));
+
+        // Exact over ticks, so unsure only means out of budget
+        if (verdict == POINTS_UNSURE) {
+            verdict = task_schedulable_ticks(set, i) ? POINTS_MEET : POINTS_MISS;
+        }
+
+        INSTRUMENT_TASK(i);
+        if (verdict == POINTS_MISS) {
+            return 0;
+        }
+        rate += 1.0 / set->period[i];
+    }
+
+    return 1;
+}
+
+int rta_bound_schedulable(PrioritySet *set) {
+
+    /*
+     * Treat each task as an implicit-deadline task with period min(D_i, P_i).
+     * That only adds interference, and if our order is rate monotonic for
+     * those periods the classic bounds apply to it:
+     *
+     *     Liu & Layland:  ∑ u_i <= n(2^(1/n) - 1)
+     *     Hyperbolic:     ∏ (u_i + 1) <= 2
+     */
+
+    // The bounds leave no room for blocking
+    if (set->blocking != NULL) {
+        return 0;
+    }
+
+    unsigned int n = set->num_tasks;
+    double density = 0.0, product = 1.0, previous = 0.0;
+
+    for (unsigned int i = 0; i < n; i++) {
+
+        double window = fmin(set->deadline[i], set->period[i]);
+        if (window < previous) {
+            // Not rate monotonic in the shortened periods
+            return 0;
+        }
+        previous = window;
+
+        double u = set->wcet[i] / window;
+        density += u;
+        product *= u + 1.0;
+    }
+
+    // The bounds themselves are irrational, so keep a margin for the
+    // rounding in the double sums rather than risk accepting a set that sits
+    // exactly on one
+    return n == 0 || density <= n * (exp2(1.0 / n) - 1.0) - RTA_BOUND_MARGIN
+           || product <= 2.0 - RTA_BOUND_MARGIN;
+}
+
+int rta_bound_schedulable_ticks(PrioritySetTicks *set) {
+
+    unsigned int n = set->num_tasks;
+    double density = 0.0, product = 1.0;
+    ticks_t previous = 0;
+
+    for (unsigned int i = 0; i < n; i++) {
+
+        ticks_t window = ticks_min(set->deadline[i], set->period[i]);
+        if (window < previous) {
+            return 0;
+        }
+        previous = window;
+
+        double u = (double) set->wcet[i] / window;
+        density += u;
+        product *= u + 1.0;
+    }
+
+    return n == 0 || density <= n * (exp2(1.0 / n) - 1.0) - RTA_BOUND_MARGIN
+           || product <= 2.0 - RTA_BOUND_MARGIN;
+}
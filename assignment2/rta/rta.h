@@ -0,0 +1,145 @@
+#ifndef RTA_H
+#define RTA_H
+
+#include "../task_types.h"
+#include "../ticks/ticks.h"
+
+typedef enum PriorityOrder {
+
+    PRIORITY_BY_PERIOD,     // Rate monotonic
+    PRIORITY_BY_DEADLINE,   // Deadline monotonic
+
+} PriorityOrder;
+
+/*
+ * Task set sorted into descending priority and split into one contiguous
+ * array per parameter. Task k's higher priority tasks are exactly 0..k-1, so
+ * the response-time recurrence only ever walks a prefix of each array.
+ */
+typedef struct PrioritySet {
+
+    unsigned int num_tasks;
+    double *wcet;
+    double *period;
+    double *deadline;
+
+    // 1 / period, for the vector interference kernels
+    double *inv_period;
+
+    // Blocking terms, see blocking.h. NULL when nothing blocks
+    double *blocking;
+
+    // Each task's index in the task set, or any key that rises with it.
+    // Response times add up the interference in that order, as summing over
+    // the unsorted set does, since doubles summed in another order can round
+    // to the other side of a deadline. NULL sums in priority order
+    unsigned int *input;
+
+} PrioritySet;
+
+// Declares a PrioritySet for n tasks with its arrays on the stack
+#define PRIORITY_SET_ON_STACK(name, n)                                          \
+    double name##_storage[4 * (n) + 1];                                         \
+    unsigned int name##_input[(n) + 1];                                         \
+    PrioritySet name = {(n), name##_storage, name##_storage + (n),              \
+                        name##_storage + 2 * (n), name##_storage + 3 * (n),     \
+                        NULL, name##_input}
+
+// Integer tick version of PrioritySet, see ticks/ticks.h
+typedef struct PrioritySetTicks {
+
+    unsigned int num_tasks;
+    ticks_t *wcet;
+    ticks_t *period;
+    ticks_t *deadline;
+
+} PrioritySetTicks;
+
+#define PRIORITY_SET_TICKS_ON_STACK(name, n)                                    \
+    ticks_t name##_storage[3 * (n) + 1];                                        \
+    PrioritySetTicks name = {(n), name##_storage, name##_storage + (n),         \
+                             name##_storage + 2 * (n)}
+
+// Stable merge sort of index[0..n) by key[index[i]], scratch holds n entries
+void sort_indices(unsigned int *index, unsigned int *scratch, const double *key, unsigned int n);
+
+// Fills index with task_set's task indices in priority order, ties as below
+void priority_order(unsigned int *index, TaskSet *task_set, PriorityOrder order);
+
+/*
+ * Fills set from task_set in priority order. Ties keep their order in the
+ * task set, so of two tasks with equal keys the earlier one wins. If
+ * set->blocking is set it gets the blocking terms for that order, and if
+ * set->input is each task's index in task_set.
+ */
+void priority_set_build(PrioritySet *set, TaskSet *task_set, PriorityOrder order);
+void priority_set_build_ticks(PrioritySetTicks *set, TaskSet *task_set, PriorityOrder order);
+
+// Returns 1 if every task's worst-case response time is within its deadline
+int rta_schedulable(PrioritySet *set);
+
+/*
+ * rta_schedulable with each task's recurrence started from response[i]
+ * instead of 0, which saves iterations when response[] holds response times
+ * of a set with the same priorities and no larger WCETs. Every entry must be
+ * a lower bound on the task's response time. Tasks before first are taken
+ * as already checked, for when only tasks from first on changed. Overwrites
+ * response[] with the response times found, up to the first task that
+ * misses. A response time that lands on a higher priority release or past
+ * the period is redone from 0, so unless WCETs go below the iteration's
+ * 0.0001 tolerance the results are bit for bit rta_schedulable's.
+ */
+int rta_schedulable_from(PrioritySet *set, unsigned int first, double *response);
+
+// Exact version over integer ticks, converges on plain equality
+int rta_schedulable_ticks(PrioritySetTicks *set);
+
+/*
+ * Exact test by whichever of the response-time iteration and the
+ * scheduling points (see points.h) is estimated to be cheaper for set, or
+ * the one forced by rta_method_use. Sets *method to the test picked. Tasks
+ * the points can't settle within budget or in doubles go to the iteration.
+ */
+int rta_exact_schedulable(PrioritySet *set, analysis_method *method);
+int rta_exact_schedulable_ticks(PrioritySetTicks *set, analysis_method *method);
+
+// Forces one exact test for every later analysis, METHOD_NONE to pick per set
+void rta_method_use(analysis_method method);
+
+// The test rta_method_use forced, METHOD_NONE if none
+analysis_method rta_method_forced(void);
+
+// Parses "auto", "rta" or "points", returns -1 otherwise
+int rta_method_parse(const char *name, analysis_method *method);
+
+/*
+ * Worst-case response time of every task of task_set under the given
+ * priority order, blocking included, stored in task_set's order. Tasks whose response time
+ * passes their period, where the recurrence stops being exact, get INFINITY.
+ */
+void rta_response_times(TaskSet *task_set, PriorityOrder order, double *response);
+
+/*
+ * Returns 1 if task_set's verdict under the given priority order could come
+ * out differently for the same tasks in another input order, which sets the
+ * order the sums are taken in: the bound sums lie within rounding of a bound,
+ * or, if exact, some response time iteration comes within its tolerance of a
+ * higher priority release, the task's deadline or its period. Priority ties
+ * aren't looked for. Critical sections are left out.
+ */
+int rta_order_sensitive(TaskSet *task_set, PriorityOrder order, int exact);
+
+// How far below the Liu & Layland and hyperbolic bounds a set must stay to pass them
+#define RTA_BOUND_MARGIN 1e-9
+
+/*
+ * Sufficient test: returns 1 if the set passes the Liu & Layland or the
+ * hyperbolic bound, 0 if it can't tell, as for any set with blocking. Applied to densities C_i/min(D_i, P_i)
+ * so it holds for constrained deadlines, as long as the priority order is
+ * also sorted by min(D_i, P_i). Sets within RTA_BOUND_MARGIN of a bound are
+ * left to the exact test.
+ */
+int rta_bound_schedulable(PrioritySet *set);
+int rta_bound_schedulable_ticks(PrioritySetTicks *set);
+
+#endif //RTA_H
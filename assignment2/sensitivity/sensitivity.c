@@ -0,0 +1,174 @@
+#include <math.h>
+#include <string.h>
+
+#include "sensitivity.h"
+#include "../edf/edf.h"
+#include "../rta/rta.h"
+
+// Returns 1 if the set scaled by scale is schedulable
+typedef int (*probe_fn)(double scale, void *ctx);
+
+typedef struct FixedPriorityProbe {
+
+    PrioritySet *base;
+    PrioritySet *scaled;
+
+    // Response times at the largest schedulable scale so far, and scratch
+    double *response;
+    double *trial;
+
+} FixedPriorityProbe;
+
+/*
+ * No scale above min(1/U, min D_i/C_i) can be schedulable: past the first
+ * the processor is overloaded, past the second some job has more work than
+ * fits before its deadline.
+ */
+static double scale_limit(TaskSet *task_set) {
+
+    double utilization = 0.0, limit = INFINITY;
+
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        Task *task = &task_set->tasks[i];
+        if (task->wcet > 0) {
+            utilization += task->wcet / task->period;
+            limit = fmin(limit, task->deadline / task->wcet);
+        }
+    }
+
+    return utilization > 0 ? fmin(limit, 1.0 / utilization) : INFINITY;
+}
+
+/*
+ * lo must be schedulable. hi is probed first, as it often is schedulable
+ * itself, then 1, so the factor agrees with the set's own verdict even when
+ * it sits exactly on 1.
+ */
+static double bisect(double lo, double hi, probe_fn probe, void *ctx) {
+
+    if (isinf(hi) || probe(hi, ctx)) {
+        return hi;
+    }
+
+    if (lo < 1.0 && 1.0 < hi) {
+        if (probe(1.0, ctx)) {
+            lo = 1.0;
+        } else {
+            hi = 1.0;
+        }
+    }
+
+    while (hi - lo > SENSITIVITY_TOLERANCE * hi) {
+
+        double mid = lo + (hi - lo) / 2;
+
+        if (probe(mid, ctx)) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static int edf_probe(double scale, void *ctx) {
+
+    TaskSet *task_set = ctx;
+    Task tasks[task_set->num_tasks + 1];
+    TaskSet scaled = {task_set->num_tasks, tasks, NULL};
+
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        tasks[i] = task_set->tasks[i];
+        tasks[i].wcet *= scale;
+    }
+
+    return edf_analysis(&scaled).is_schedulable;
+}
+
+double edf_sensitivity(TaskSet *task_set) {
+
+    double utilization = 0.0;
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        utilization += task_set->tasks[i].wcet / task_set->tasks[i].period;
+    }
+
+    /*
+     * Near a scaled utilization of 1 the busy period grows like 1 / (1 - U)
+     * and at 1 it can run to the hyperperiod, so stop one tolerance short.
+     * Below 1 / density every set passes the density bound, no probe needed.
+     */
+    double limit = fmin(scale_limit(task_set), (1.0 - SENSITIVITY_TOLERANCE) / utilization);
+    if (isinf(limit)) {
+        return limit;
+    }
+
+    double density = 0.0;
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+        Task *task = &task_set->tasks[i];
+        if (task->wcet > 0) {
+            density += task->wcet / fmin(task->deadline, task->period);
+        }
+    }
+
+    double scale = bisect(fmin(1.0 / density, limit), limit, edf_probe, task_set);
+
+    // Only cut short by the cap, and the set itself is schedulable
+    if (scale < 1.0 && scale == limit && edf_analysis(task_set).is_schedulable) {
+        scale = 1.0;
+    }
+
+    return scale;
+}
+
+static int fixed_priority_probe(double scale, void *ctx) {
+
+    FixedPriorityProbe *probe = ctx;
+    unsigned int n = probe->base->num_tasks;
+
+    for (unsigned int k = 0; k < n; k++) {
+        probe->scaled->wcet[k] = probe->base->wcet[k] * scale;
+    }
+
+    // Response times only grow with the scale, so the last schedulable
+    // probe's are lower bounds for every later, larger one
+    memcpy(probe->trial, probe->response, n * sizeof(double));
+
+    if (!rta_schedulable_from(probe->scaled, 0, probe->trial)) {
+        return 0;
+    }
+
+    memcpy(probe->response, probe->trial, n * sizeof(double));
+    return 1;
+}
+
+static double fixed_priority_sensitivity(TaskSet *task_set, PriorityOrder order) {
+
+    unsigned int n = task_set->num_tasks;
+    PRIORITY_SET_ON_STACK(base, n);
+    PRIORITY_SET_ON_STACK(scaled, n);
+    double response[n + 1], trial[n + 1];
+
+    // Sorted once, only the WCETs change between probes
+    priority_set_build(&base, task_set, order);
+    memcpy(scaled.period, base.period, n * sizeof(double));
+    memcpy(scaled.deadline, base.deadline, n * sizeof(double));
+    memcpy(scaled.inv_period, base.inv_period, n * sizeof(double));
+    memcpy(scaled.input, base.input, n * sizeof(unsigned int));
+    memset(response, 0, n * sizeof(double));
+
+    FixedPriorityProbe probe = {&base, &scaled, response, trial};
+    return bisect(0.0, scale_limit(task_set), fixed_priority_probe, &probe);
+}
+
+double rm_sensitivity(TaskSet *task_set) {
+
+    return fixed_priority_sensitivity(task_set, PRIORITY_BY_PERIOD);
+
+}
+
+double dm_sensitivity(TaskSet *task_set) {
+
+    return fixed_priority_sensitivity(task_set, PRIORITY_BY_DEADLINE);
+
+}
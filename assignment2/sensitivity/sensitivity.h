@@ -0,0 +1,27 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include "../task_types.h"
+
+/*
+ * Breakdown factors: the largest α such that the set with every WCET scaled
+ * by α is still schedulable, so α < 1 for unschedulable sets and α - 1 is
+ * the headroom of schedulable ones. Found by bisection between a factor
+ * known to be schedulable and one known not to be, to within
+ * SENSITIVITY_TOLERANCE relative; the schedulable end is returned.
+ *
+ * A set whose WCETs are all 0 stays schedulable at any scale, INFINITY.
+ */
+
+#define SENSITIVITY_TOLERANCE 1e-4
+
+typedef double (*sensitivity_fn)(TaskSet *task_set);
+
+double edf_sensitivity(TaskSet *task_set);
+
+// Each probe starts the response-time recurrences from the last schedulable
+// probe's response times, which bound the new ones from below
+double rm_sensitivity(TaskSet *task_set);
+double dm_sensitivity(TaskSet *task_set);
+
+#endif //SENSITIVITY_H
@@ -0,0 +1,312 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "sim.h"
+#include "../rta/rta.h"
+
+// Hyperperiods are clamped here, far beyond any simulation that finishes
+#define TIME_LIMIT (INT64_MAX / 4)
+
+// Position of a task not in a heap
+#define NOT_QUEUED ((unsigned int) -1)
+
+/*
+ * Binary min-heap of task indices by key[task], ties to the lower index.
+ * position[] finds a task's slot so its key can change in place.
+ */
+typedef struct Heap {
+
+    unsigned int size;
+    unsigned int *tasks;
+    unsigned int *position;
+    const ticks_t *key;
+
+} Heap;
+
+typedef struct Simulation {
+
+    TaskTicks *tasks;
+
+    // Next release of each task, and its released but unfinished jobs: the
+    // oldest released at head_release, remaining ticks left of it
+    ticks_t *next_release;
+    unsigned int *pending;
+    ticks_t *head_release;
+    ticks_t *remaining;
+
+    // Absolute deadline of each task's oldest job, and its ready key
+    ticks_t *deadline;
+    ticks_t *priority;
+
+    Heap releases;
+    Heap ready;
+    Heap deadlines;
+
+    SimPolicy policy;
+    unsigned long jobs;
+
+} Simulation;
+
+static inline int before(const Heap *heap, unsigned int a, unsigned int b) {
+
+    return heap->key[a] < heap->key[b] || (heap->key[a] == heap->key[b] && a < b);
+
+}
+
+static void place(Heap *heap, unsigned int slot, unsigned int task) {
+
+    heap->tasks[slot] = task;
+    heap->position[task] = slot;
+}
+
+static void sift_up(Heap *heap, unsigned int slot) {
+
+    unsigned int task = heap->tasks[slot];
+
+    while (slot > 0) {
+        unsigned int parent = (slot - 1) / 2;
+        if (!before(heap, task, heap->tasks[parent])) {
+            break;
+        }
+        place(heap, slot, heap->tasks[parent]);
+        slot = parent;
+    }
+
+    place(heap, slot, task);
+}
+
+static void sift_down(Heap *heap, unsigned int slot) {
+
+    unsigned int task = heap->tasks[slot];
+
+    for (;;) {
+        unsigned int child = 2 * slot + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && before(heap, heap->tasks[child + 1], heap->tasks[child])) {
+            child++;
+        }
+        if (!before(heap, heap->tasks[child], task)) {
+            break;
+        }
+        place(heap, slot, heap->tasks[child]);
+        slot = child;
+    }
+
+    place(heap, slot, task);
+}
+
+static void heap_push(Heap *heap, unsigned int task) {
+
+    place(heap, heap->size++, task);
+    sift_up(heap, heap->size - 1);
+}
+
+static void heap_remove(Heap *heap, unsigned int task) {
+
+    unsigned int slot = heap->position[task];
+    unsigned int last = heap->tasks[--heap->size];
+
+    heap->position[task] = NOT_QUEUED;
+    if (slot < heap->size) {
+        place(heap, slot, last);
+        sift_up(heap, slot);
+        sift_down(heap, heap->position[last]);
+    }
+}
+
+// Restores the order after task's key changed
+static void heap_update(Heap *heap, unsigned int task) {
+
+    sift_up(heap, heap->position[task]);
+    sift_down(heap, heap->position[task]);
+}
+
+static inline unsigned int heap_top(const Heap *heap) {
+
+    return heap->tasks[0];
+
+}
+
+static ticks_t gcd(ticks_t a, ticks_t b) {
+
+    while (b != 0) {
+        ticks_t r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+// Hyperperiod plus the longest deadline, clamped to TIME_LIMIT
+static ticks_t time_limit(TaskTicks *tasks, unsigned int n) {
+
+    ticks_t hyperperiod = 1, longest = 0;
+
+    for (unsigned int i = 0; i < n; i++) {
+        ticks_t factor = tasks[i].period / gcd(hyperperiod, tasks[i].period);
+        hyperperiod = hyperperiod > TIME_LIMIT / factor ? TIME_LIMIT : hyperperiod * factor;
+        longest = tasks[i].deadline > longest ? tasks[i].deadline : longest;
+    }
+
+    return hyperperiod > TIME_LIMIT - longest ? TIME_LIMIT : hyperperiod + longest;
+}
+
+// Makes the oldest pending job of task the one the heaps see
+static void queue_head(Simulation *sim, unsigned int task, int queued) {
+
+    sim->remaining[task] = sim->tasks[task].wcet;
+    sim->deadline[task] = sim->head_release[task] + sim->tasks[task].deadline;
+
+    if (queued) {
+        heap_update(&sim->deadlines, task);
+        if (sim->policy == SIM_EDF) {
+            heap_update(&sim->ready, task);
+        }
+    } else {
+        heap_push(&sim->deadlines, task);
+        heap_push(&sim->ready, task);
+    }
+}
+
+static void release(Simulation *sim, unsigned int task, ticks_t now) {
+
+    sim->jobs++;
+    sim->next_release[task] = now + sim->tasks[task].period;
+    heap_update(&sim->releases, task);
+
+    // Jobs without work are done as soon as they're released
+    if (sim->tasks[task].wcet == 0) {
+        return;
+    }
+
+    if (sim->pending[task]++ == 0) {
+        sim->head_release[task] = now;
+        queue_head(sim, task, 0);
+    }
+}
+
+static void complete(Simulation *sim, unsigned int task) {
+
+    if (--sim->pending[task] > 0) {
+        sim->head_release[task] += sim->tasks[task].period;
+        queue_head(sim, task, 1);
+    } else {
+        heap_remove(&sim->ready, task);
+        heap_remove(&sim->deadlines, task);
+    }
+}
+
+int sim_scratch_init(SimScratch *scratch, unsigned int max_tasks) {
+
+    size_t n = (size_t) max_tasks + 1;
+
+    *scratch = (SimScratch) {max_tasks};
+    scratch->storage = malloc(5 * n * sizeof(ticks_t));
+    scratch->indices = malloc(8 * n * sizeof(unsigned int));
+
+    if (scratch->storage == NULL || scratch->indices == NULL) {
+        sim_scratch_free(scratch);
+        return -1;
+    }
+
+    return 0;
+}
+
+void sim_scratch_free(SimScratch *scratch) {
+
+    free(scratch->storage);
+    free(scratch->indices);
+    *scratch = (SimScratch) {0};
+}
+
+SimResult sim_run(TaskSet *task_set, SimScratch *scratch, SimPolicy policy, unsigned long max_jobs) {
+
+    unsigned int n = task_set->num_tasks;
+    TaskTicks *tasks = task_set->ticks;
+    SimResult result = {SIM_SCHEDULABLE, SIM_NO_TASK, 0, 0};
+
+    if (n == 0) {
+        return result;
+    }
+
+    // Five ticks_t and eight unsigned int arrays of n + 1 entries
+    size_t stride = (size_t) scratch->max_tasks + 1;
+    ticks_t *next_release = scratch->storage, *head_release = next_release + stride;
+    ticks_t *remaining = head_release + stride, *deadline = remaining + stride, *priority = deadline + stride;
+    unsigned int *pending = scratch->indices, *index = pending + stride;
+    unsigned int *heap_tasks = index + stride, *heap_position = heap_tasks + 3 * stride;
+
+    Simulation sim = {tasks, next_release, pending, head_release, remaining, deadline, priority};
+    sim.releases = (Heap) {0, heap_tasks, heap_position, next_release};
+    sim.ready = (Heap) {0, heap_tasks + stride, heap_position + stride, policy == SIM_EDF ? deadline : priority};
+    sim.deadlines = (Heap) {0, heap_tasks + 2 * stride, heap_position + 2 * stride, deadline};
+    sim.policy = policy;
+    sim.jobs = 0;
+
+    if (policy != SIM_EDF) {
+        priority_order(index, task_set, policy == SIM_RM ? PRIORITY_BY_PERIOD : PRIORITY_BY_DEADLINE);
+        for (unsigned int k = 0; k < n; k++) {
+            priority[index[k]] = k;
+        }
+    }
+
+    for (unsigned int i = 0; i < n; i++) {
+        next_release[i] = 0;
+        pending[i] = 0;
+        heap_push(&sim.releases, i);
+    }
+
+    ticks_t limit = time_limit(tasks, n);
+    ticks_t now = 0;
+
+    for (;;) {
+
+        // Every job released before now is done: the busy period is over
+        if (now > 0 && sim.ready.size == 0) {
+            break;
+        }
+
+        while (next_release[heap_top(&sim.releases)] == now) {
+            release(&sim, heap_top(&sim.releases), now);
+        }
+
+        if (sim.ready.size == 0) {
+            break;
+        }
+
+        unsigned int running = heap_top(&sim.ready);
+        ticks_t next = next_release[heap_top(&sim.releases)];
+        if (now + remaining[running] < next) {
+            next = now + remaining[running];
+        }
+
+        // The earliest deadline passes before the next event: that job can't
+        // be done by then, being either not running or running too long
+        unsigned int late = heap_top(&sim.deadlines);
+        if (deadline[late] < next) {
+            result.outcome = SIM_DEADLINE_MISS;
+            result.task = late;
+            now = deadline[late];
+            break;
+        }
+
+        if (next > limit || sim.jobs > max_jobs) {
+            result.outcome = SIM_UNDECIDED;
+            break;
+        }
+
+        remaining[running] -= next - now;
+        now = next;
+
+        if (remaining[running] == 0) {
+            complete(&sim, running);
+        }
+    }
+
+    result.time = now;
+    result.jobs = sim.jobs;
+    return result;
+}
@@ -0,0 +1,72 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "../task_types.h"
+
+/*
+ * Discrete-event simulator of the preemptive EDF, RM and DM schedules, to
+ * check the analyses against. Time is in ticks, so task_set->ticks must be
+ * filled. Every task releases its first job at 0 and the next ones exactly a
+ * period apart, the worst case the analyses assume, and runs for its full
+ * WCET. Fixed priority ties go to the earlier task as in the analyses.
+ *
+ * Time jumps from event to event: releases come off a heap ordered by
+ * release time and the running job is the top of a heap ordered by absolute
+ * deadline or priority. The simulation ends at the first deadline miss, or
+ * with the synchronous busy period: once every job released so far is done
+ * no later job can miss either. That is usually far before the hyperperiod,
+ * which with U <= 1 the busy period never passes. Sets that run on past the
+ * hyperperiod plus the longest deadline, or past max_jobs releases, are left
+ * undecided.
+ */
+
+typedef enum SimPolicy {
+
+    SIM_EDF,
+    SIM_RM,
+    SIM_DM,
+
+} SimPolicy;
+
+typedef enum SimOutcome {
+
+    SIM_SCHEDULABLE,
+    SIM_DEADLINE_MISS,
+    SIM_UNDECIDED,
+
+} SimOutcome;
+
+// Task of SimResult when no job missed its deadline
+#define SIM_NO_TASK ((unsigned int) -1)
+
+typedef struct SimResult {
+
+    SimOutcome outcome;
+
+    // First job to miss its deadline, and that deadline. Otherwise the time
+    // the simulation stopped at
+    unsigned int task;
+    ticks_t time;
+
+    // Jobs released
+    unsigned long jobs;
+
+} SimResult;
+
+// Per-task state of a run, reused from set to set by one thread
+typedef struct SimScratch {
+
+    unsigned int max_tasks;
+    ticks_t *storage;
+    unsigned int *indices;
+
+} SimScratch;
+
+// Returns 0, or -1 if out of memory
+int sim_scratch_init(SimScratch *scratch, unsigned int max_tasks);
+void sim_scratch_free(SimScratch *scratch);
+
+// task_set has at most scratch->max_tasks tasks
+SimResult sim_run(TaskSet *task_set, SimScratch *scratch, SimPolicy policy, unsigned long max_jobs);
+
+#endif //SIM_H
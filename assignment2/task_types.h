@@ -3,6 +3,8 @@
 #ifndef TASK_TYPES_H
 #define TASK_TYPES_H
 
+#include <stdint.h>
+
 ////////////////////////////////////////////////////////////////////////////////
 // DATA STRUCTURES
 
@@ -14,11 +16,41 @@ typedef struct Task {
 
 } Task;
 
+// Time in hundredths of a unit, the generator's resolution
+typedef int64_t ticks_t;
+
+#define TICKS_PER_UNIT 100
+
+typedef struct TaskTicks {
+
+    ticks_t wcet;
+    ticks_t deadline;
+    ticks_t period;
+
+} TaskTicks;
+
+// A task's longest critical section on one shared resource
+typedef struct CriticalSection {
+
+    unsigned int task;
+    unsigned int resource;
+    double length;
+
+} CriticalSection;
+
 typedef struct TaskSet {
 
     unsigned int num_tasks;
     Task *tasks;
 
+    // Same parameters as whole ticks, NULL unless running in tick mode
+    TaskTicks *ticks;
+
+    // Critical sections of all tasks, in task order. None unless the input
+    // lists them
+    unsigned int num_sections;
+    CriticalSection *sections;
+
 } TaskSet;
 
 typedef struct ProgramInfo {
@@ -28,10 +60,32 @@ typedef struct ProgramInfo {
 
 } ProgramInfo;
 
+// Which stage of an analysis settled the verdict, cheapest first
+typedef enum analysis_tier
+{
+	TIER_UTILIZATION,	// Rejected outright, U > 1
+	TIER_BOUND,		// Accepted by a sufficient utilization or density bound
+	TIER_EXACT,		// Needed the exact test
+	NUM_TIERS
+} analysis_tier;
+
+// How a fixed priority exact test was done, when one was
+typedef enum analysis_method
+{
+	METHOD_NONE,		// Decided before any exact test, or not fixed priority
+	METHOD_RTA,		// Response-time iteration
+	METHOD_POINTS,		// Scheduling points
+	NUM_METHODS
+} analysis_method;
+
 typedef struct analysis_results
 {
 	int is_schedulable;
 	double utilization;
+	analysis_tier tier;
+	analysis_method method;
 } analysis_results;
 
+typedef analysis_results (*analysis_fn)(TaskSet *task_set);
+
 #endif
@@ -0,0 +1,236 @@
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ticks.h"
+
+// Parameters further than this from a whole tick were not written with two decimals
+#define TICK_TOLERANCE 1e-6
+
+static int to_ticks(double value, double smallest, ticks_t *ticks) {
+
+    double scaled = value * TICKS_PER_UNIT;
+    double rounded = round(scaled);
+
+    if (!(rounded >= smallest && rounded < 0x1p62) || fabs(scaled - rounded) > TICK_TOLERANCE) {
+        return -1;
+    }
+
+    *ticks = (ticks_t) rounded;
+    return 0;
+}
+
+int ticks_convert(TaskSet *task_set, TaskTicks *ticks, unsigned int *bad_task) {
+
+    for (unsigned int i = 0; i < task_set->num_tasks; i++) {
+
+        Task *task = &task_set->tasks[i];
+
+        // Zero WCETs do show up in generated sets, zero periods can't
+        if (to_ticks(task->wcet, 0.0, &ticks[i].wcet) != 0
+            || to_ticks(task->deadline, 0.0, &ticks[i].deadline) != 0
+            || to_ticks(task->period, 1.0, &ticks[i].period) != 0) {
+            *bad_task = i;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static ticks_t gcd(ticks_t a, ticks_t b) {
+
+    while (b != 0) {
+        ticks_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+// wcet / window of task i is the utilization or the density term
+static inline ticks_t window(TaskTicks *t, int density) {
+
+    return density ? ticks_min(t->deadline, t->period) : t->period;
+
+}
+
+/*
+ * Unsigned integer of size 64-bit limbs, least significant first, for sums
+ * whose common denominator outgrows 128 bits. Only what compare_sum needs:
+ * products and quotients with one limb, and sums.
+ */
+typedef struct Wide {
+
+    unsigned int size;
+    uint64_t *limb;
+
+} Wide;
+
+static void wide_set(Wide *a, unsigned __int128 value) {
+
+    a->limb[0] = (uint64_t) value;
+    a->limb[1] = (uint64_t) (value >> 64);
+    a->size = a->limb[1] != 0 ? 2 : 1;
+}
+
+static void wide_mul(Wide *a, uint64_t m) {
+
+    unsigned __int128 carry = 0;
+
+    for (unsigned int k = 0; k < a->size; k++) {
+        carry += (unsigned __int128) a->limb[k] * m;
+        a->limb[k] = (uint64_t) carry;
+        carry >>= 64;
+    }
+
+    if (carry != 0) {
+        a->limb[a->size++] = (uint64_t) carry;
+    }
+}
+
+static void wide_add(Wide *a, const Wide *b) {
+
+    unsigned __int128 carry = 0;
+
+    for (unsigned int k = 0; k < a->size || k < b->size; k++) {
+        carry += (unsigned __int128) (k < a->size ? a->limb[k] : 0) + (k < b->size ? b->limb[k] : 0);
+        a->limb[k] = (uint64_t) carry;
+        carry >>= 64;
+    }
+
+    a->size = a->size > b->size ? a->size : b->size;
+    if (carry != 0) {
+        a->limb[a->size++] = (uint64_t) carry;
+    }
+}
+
+// q = a / d, returns a % d. q may be a
+static uint64_t wide_div(Wide *q, const Wide *a, uint64_t d) {
+
+    unsigned __int128 rest = 0;
+
+    for (unsigned int k = a->size; k-- > 0;) {
+        rest = rest << 64 | a->limb[k];
+        if (q != NULL) {
+            q->limb[k] = (uint64_t) (rest / d);
+        }
+        rest %= d;
+    }
+
+    if (q != NULL) {
+        q->size = a->size;
+        while (q->size > 1 && q->limb[q->size - 1] == 0) {
+            q->size--;
+        }
+    }
+
+    return (uint64_t) rest;
+}
+
+static int wide_compare(const Wide *a, const Wide *b) {
+
+    if (a->size != b->size) {
+        return a->size < b->size ? -1 : 1;
+    }
+
+    for (unsigned int k = a->size; k-- > 0;) {
+        if (a->limb[k] != b->limb[k]) {
+            return a->limb[k] < b->limb[k] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+static int compare_sum(TaskSet *task_set, int density) {
+
+    /*
+     * Accumulate ∑ wcet/window as a fraction over the least common multiple
+     * of the windows so far. With a few dozen periods that can outgrow 128
+     * bits, and the sum carries on in Wide integers from where it got to.
+     * Every term is at least 0, so once the sum passes 1 it stays there.
+     */
+
+    unsigned int n = task_set->num_tasks;
+    __int128 num = 0, den = 1;
+    const __int128 limit = (__int128) 1 << 100;
+    unsigned int i = 0;
+
+    for (; i < n; i++) {
+
+        TaskTicks *t = &task_set->ticks[i];
+        ticks_t w = window(t, density);
+        if (t->wcet == 0) {
+            continue;
+        }
+        if (w == 0) {
+            // Work due immediately
+            return 1;
+        }
+
+        ticks_t g = gcd((ticks_t) (den % w), w);
+        __int128 scale = w / g;
+
+        if (den > limit / scale || den / g > limit / t->wcet) {
+            break;
+        }
+
+        // num/den + wcet/w over the common denominator den * w / g
+        num = num * scale + (__int128) t->wcet * (den / g);
+        den *= scale;
+
+        if (num > den) {
+            return 1;
+        }
+    }
+
+    if (i == n) {
+        return num < den ? -1 : num > den;
+    }
+
+    // The denominator gains at most one limb per task, and num at most one
+    // more on top of it with the last term
+    uint64_t storage[3 * (n + 3)];
+    Wide wide_num = {0, storage}, wide_den = {0, storage + n + 3}, term = {0, storage + 2 * (n + 3)};
+    wide_set(&wide_num, (unsigned __int128) num);
+    wide_set(&wide_den, (unsigned __int128) den);
+
+    for (; i < n; i++) {
+
+        TaskTicks *t = &task_set->ticks[i];
+        ticks_t w = window(t, density);
+        if (t->wcet == 0) {
+            continue;
+        }
+        if (w == 0) {
+            return 1;
+        }
+
+        uint64_t g = (uint64_t) gcd((ticks_t) wide_div(NULL, &wide_den, (uint64_t) w), w);
+
+        wide_div(&term, &wide_den, g);
+        wide_mul(&term, (uint64_t) t->wcet);
+        wide_mul(&wide_num, (uint64_t) w / g);
+        wide_add(&wide_num, &term);
+        wide_mul(&wide_den, (uint64_t) w / g);
+
+        if (wide_compare(&wide_num, &wide_den) > 0) {
+            return 1;
+        }
+    }
+
+    return wide_compare(&wide_num, &wide_den);
+}
+
+int ticks_compare_utilization(TaskSet *task_set) {
+
+    return compare_sum(task_set, 0);
+
+}
+
+int ticks_compare_density(TaskSet *task_set) {
+
+    return compare_sum(task_set, 1);
+
+}
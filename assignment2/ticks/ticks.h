@@ -0,0 +1,39 @@
+#ifndef TICKS_H
+#define TICKS_H
+
+#include "../task_types.h"
+
+/*
+ * Integer tick arithmetic. Every value the generator writes has two decimal
+ * places, so converting to hundredths makes the analyses exact: ceilings are
+ * integer divisions and fixed points are reached with plain equality.
+ */
+
+/*
+ * Fills ticks[] from task_set->tasks. Returns 0, or -1 with *bad_task set if
+ * some parameter isn't a whole number of ticks or a period is zero.
+ */
+int ticks_convert(TaskSet *task_set, TaskTicks *ticks, unsigned int *bad_task);
+
+static inline ticks_t ticks_ceil_div(ticks_t a, ticks_t b) {
+
+    return (a + b - 1) / b;
+
+}
+
+static inline ticks_t ticks_min(ticks_t a, ticks_t b) {
+
+    return a < b ? a : b;
+
+}
+
+/*
+ * Compares ∑ wcet/period with 1 exactly. Returns -1, 0 or 1 for utilization
+ * below, equal to or above 1.
+ */
+int ticks_compare_utilization(TaskSet *task_set);
+
+// Same for the density ∑ wcet/min(deadline, period)
+int ticks_compare_density(TaskSet *task_set);
+
+#endif //TICKS_H